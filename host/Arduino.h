@@ -0,0 +1,121 @@
+/*
+    ================================================================
+                   HOST SHIM: Arduino core subset
+    ================================================================
+
+    Just enough of the Arduino-ESP32 API for src/ to build and run on a
+    Linux box ([env:native]). Time comes from clock.h, so with the host
+    clock simulated, delay() and millis() run faster than real time.
+
+    Host-only hooks (hostSetPinLevel, hostSchedulePinLevel, hostSetStopAt,
+    hostSerialAttach) let a driver inject button presses, bound a run and
+    wire the serial port to a pty.
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+
+#define RISING        0x01
+#define FALLING       0x02
+#define CHANGE        0x03
+
+#define IRAM_ATTR
+#define digitalPinToInterrupt(p)  (p)
+
+#ifndef PI
+#define PI            3.1415926535897932384626433832795
+#endif
+#define HALF_PI       1.5707963267948966192313216916398
+#define TWO_PI        6.283185307179586476925286766559
+
+typedef uint8_t byte;
+
+/* ---------------- TIMING ---------------- */
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/* ---------------- GPIO ---------------- */
+
+void pinMode(uint8_t pin, uint8_t mode);
+int  digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+/*
+    Host "ISRs" run synchronously in whichever thread changed the pin
+    level (a host hook, or the clock advance that fired a scheduled edge).
+*/
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+/* ---------------- SERIAL ---------------- */
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud);
+    size_t print(const char *s);
+    size_t println(const char *s = "");
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t write(const uint8_t *data, size_t len);
+    void flush();
+    int available();
+    int read();
+    size_t read(uint8_t *buffer, size_t size);
+    int availableForWrite();
+    void setTxBufferSize(size_t size);
+    void setRxBufferSize(size_t size);
+};
+
+extern HardwareSerial Serial;
+
+/* ---------------- SKETCH ENTRY POINTS ---------------- */
+
+void setup();
+void loop();
+
+/* ---------------- HOST HOOKS ---------------- */
+
+// Thrown by delay() once the run deadline passes, to unwind halt loops.
+struct HostStop {};
+
+// Drive an input pin now; fires an attached interrupt on a matching edge
+void hostSetPinLevel(uint8_t pin, int level);
+
+/*
+    Same, at raw counter time `counterUs` on the simulated clock, so an
+    edge can land at any point of a frame. One pending edge at a time.
+*/
+void hostSchedulePinLevel(uint8_t pin, int level, uint64_t counterUs);
+
+/*
+    Raw counter time (readCounterMicros() base) at which delay() throws
+    HostStop. 0 = never.
+*/
+void hostSetStopAt(uint64_t counterUs);
+
+// Silence Serial output (e.g. for batch runs)
+void hostSetSerialEnabled(bool enabled);
+
+// Queue bytes for the sketch to read from Serial
+void hostSerialInject(const char *data, size_t len);
+
+/*
+    Connect Serial to a file descriptor (e.g. a pty) instead: output is
+    written to it, input read from it as it arrives. -1 goes back to
+    stdout and hostSerialInject().
+*/
+void hostSerialAttach(int fd);
@@ -0,0 +1,130 @@
+/*
+    ================================================================
+                      HOST SHIM: FastLED subset
+    ================================================================
+
+    CRGB, the 8-bit math helpers used by src/, and a CFastLED whose
+    show() captures the brightness-scaled frame into memory instead of
+    driving a strip. Each addLeds() strip is a mock output channel: like
+    the ESP32 RMT driver, show() starts every channel at once. With the
+    host clock simulated, show() advances time by the WS2812B wire time
+    of the longest strip, so frame timing stays realistic.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/* ---------------- PIXEL TYPE ---------------- */
+
+struct CRGB {
+    union {
+        struct {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode {
+        Black = 0x000000,
+        White = 0xFFFFFF,
+        Red   = 0xFF0000,
+        Green = 0x008000,
+        Blue  = 0x0000FF,
+    };
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    constexpr CRGB(HTMLColorCode code)
+        : r((uint8_t)(code >> 16)), g((uint8_t)(code >> 8)), b((uint8_t)code) {}
+
+    uint8_t &operator[](uint8_t x) { return raw[x]; }
+    const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+    bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+/* ---------------- 8-BIT MATH ---------------- */
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned t = i + j;
+    return (uint8_t)(t > 255 ? 255 : t);
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    return (uint8_t)(i > j ? i - j : 0);
+}
+
+// FASTLED_SCALE8_FIXED semantics: scale8(255, 255) == 255
+inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8);
+}
+
+// setDither() modes
+#define DISABLE_DITHER 0x00
+#define BINARY_DITHER  0x01
+
+inline void fill_solid(CRGB *leds, int numToFill, const CRGB &color) {
+    for (int i = 0; i < numToFill; ++i) leds[i] = color;
+}
+
+/* ---------------- CONTROLLER ---------------- */
+
+enum EOrder { RGB = 0012, RBG = 0021, GRB = 0102, GBR = 0120, BRG = 0201, BGR = 0210 };
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER> class WS2812B {};
+
+struct HostShownFrame {
+    uint64_t          us;          // getTimeMicros() at show()
+    uint8_t           brightness;
+    std::vector<CRGB> pixels;      // after brightness scaling, as sent
+};
+
+class CFastLED {
+public:
+    template <template <uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CFastLED &addLeds(CRGB *data, int nLeds) {
+        addStrip(data, nLeds, DATA_PIN);
+        return *this;
+    }
+
+    void show();
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    void setDither(uint8_t ditherMode) { (void)ditherMode; }   // FastLED's own dither is not modelled
+    uint8_t getBrightness() const { return brightness; }
+    void clear(bool writeData = false);
+
+    /* ---- host hooks ---- */
+
+    // Keep up to `maxFrames` shown frames in memory (0 = count only).
+    void hostSetFrameCapture(size_t maxFrames);
+    const std::vector<HostShownFrame> &hostFrames() const { return frames; }
+    uint32_t hostShowCount() const { return showCount; }
+
+    // Mock channels: wire time of the last show() per strip, and overall
+    size_t hostChannelCount() const { return strips.size(); }
+    uint32_t hostChannelWireUs(size_t channel) const;
+    uint32_t hostShowWireUs() const;
+
+private:
+    struct Strip {
+        CRGB   *data;
+        int     count;
+        uint8_t pin;
+    };
+
+    void addStrip(CRGB *data, int count, uint8_t pin);
+
+    std::vector<Strip>          strips;
+    std::vector<HostShownFrame> frames;
+    size_t                      captureLimit = 0;
+    uint32_t                    showCount = 0;
+    uint8_t                     brightness = 255;
+};
+
+extern CFastLED FastLED;
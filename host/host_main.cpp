@@ -0,0 +1,76 @@
+/*
+    Headless entry point for [env:native]: runs the unmodified sketch
+    setup()/loop() against the simulated host clock, so a whole session
+    finishes in seconds. Shown frames are kept in memory by the FastLED
+    shim (FastLED.hostFrames()).
+
+    Usage: program [seconds] [capture-frames] [panic-at]
+      seconds         simulated run length (default: full session + fade)
+      capture-frames  how many shown frames to keep in memory (default 0)
+      panic-at        press the panic button this many seconds after
+                      start (fractions land anywhere inside a frame)
+
+    With -DBINARY_TELEMETRY=1 stdout carries the telemetry stream only
+    (pipe it into telemetry_decode); the run summary goes to stderr.
+
+    Tools that bring their own main() build with -DHOST_NO_SKETCH_MAIN.
+*/
+
+#ifndef HOST_NO_SKETCH_MAIN
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <stdlib.h>
+
+#include "clock.h"
+#include "config.h"
+#include "frame_pipeline.h"
+#include "panic.h"
+#include "profiler.h"
+#include "telemetry.h"
+
+int main(int argc, char **argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : MAX_SESSION_SECONDS + 20.0;
+    size_t capture = (argc > 2) ? (size_t)atol(argv[2]) : 0;
+    double panicAt = (argc > 3) ? atof(argv[3]) : -1.0;
+
+    hostClockSetSimulated(true);
+    FastLED.hostSetFrameCapture(capture);
+
+    uint64_t startAt = readCounterMicros();
+    uint64_t stopAt = startAt + (uint64_t)(seconds * 1000000.0);
+    hostSetStopAt(stopAt);
+    if (panicAt >= 0.0) hostSchedulePinLevel(PANIC_PIN, LOW, startAt + (uint64_t)(panicAt * 1000000.0));
+
+    try {
+        setup();
+        while (readCounterMicros() < stopAt) loop();
+    } catch (const HostStop &) {
+        // halted inside a delay() loop (panic or session end)
+    }
+    stopOutputPipeline();
+
+    consolePrintln();
+    profileDump(false);
+    telemetryFlush();
+
+    // Keep a binary telemetry stream on stdout clean
+    FILE *out = USE_BINARY_TELEMETRY ? stderr : stdout;
+    if (panicActive()) {
+        fprintf(out, "\n[host] panic: %s, press-to-dark %u us\n",
+               panicDark() ? "dark" : "NOT dark", (unsigned)panicLatencyUs());
+    }
+
+    uint32_t checksum = 0;
+    for (const HostShownFrame &f : FastLED.hostFrames()) {
+        for (const CRGB &c : f.pixels) checksum = checksum * 31u + (c.r ^ (c.g << 8) ^ (c.b << 16));
+    }
+    fprintf(out, "\n[host] simulated %.1f s, %u frames shown, %zu captured, checksum %08x\n",
+           (double)(readCounterMicros() - startAt) / 1e6,
+           (unsigned)FastLED.hostShowCount(), FastLED.hostFrames().size(), (unsigned)checksum);
+    fprintf(out, "[host] %zu output channels in parallel, %u us per show()\n",
+            FastLED.hostChannelCount(), (unsigned)FastLED.hostShowWireUs());
+    return 0;
+}
+
+#endif
@@ -0,0 +1,263 @@
+#include "Arduino.h"
+#include "FastLED.h"
+
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+
+#include "clock.h"
+#include "config.h"
+
+/* ---------------- TIMING ---------------- */
+
+static uint64_t stopAtCounterUs = 0;
+
+static void hostSleepMicros(uint64_t us) {
+    if (hostClockSimulated) {
+        hostClockAdvanceMicros(us);
+    } else {
+        struct timespec ts;
+        ts.tv_sec  = (time_t)(us / 1000000ULL);
+        ts.tv_nsec = (long)(us % 1000000ULL) * 1000L;
+        nanosleep(&ts, nullptr);
+    }
+}
+
+unsigned long millis() {
+    return (unsigned long)(readCounterMicros() / 1000ULL);
+}
+
+unsigned long micros() {
+    return (unsigned long)readCounterMicros();
+}
+
+void delay(unsigned long ms) {
+    hostSleepMicros((uint64_t)ms * 1000ULL);
+    if (stopAtCounterUs != 0 && readCounterMicros() >= stopAtCounterUs) throw HostStop();
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostSleepMicros(us);
+}
+
+void hostSetStopAt(uint64_t counterUs) {
+    stopAtCounterUs = counterUs;
+}
+
+/* ---------------- GPIO ---------------- */
+
+struct HostPin {
+    int    level = HIGH;              // idle pull-up
+    void (*isr)() = nullptr;
+    int    mode = 0;
+};
+
+static HostPin pins[64];
+
+static void setPinLevel(uint8_t pin, int level) {
+    if (pin >= 64) return;
+    HostPin &p = pins[pin];
+    int prev = p.level;
+    p.level = level;
+    if (p.isr == nullptr || prev == level) return;
+
+    bool falling = (prev == HIGH && level == LOW);
+    if ((p.mode == FALLING && falling) || (p.mode == RISING && !falling) || p.mode == CHANGE) p.isr();
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+int digitalRead(uint8_t pin) {
+    return pin < 64 ? pins[pin].level : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < 64) pins[pin].level = level;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    if (pin >= 64) return;
+    pins[pin].isr = isr;
+    pins[pin].mode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < 64) pins[pin].isr = nullptr;
+}
+
+void hostSetPinLevel(uint8_t pin, int level) {
+    setPinLevel(pin, level);
+}
+
+static uint8_t scheduledPin = 0;
+static int     scheduledLevel = HIGH;
+
+static void applyScheduledPinLevel() {
+    setPinLevel(scheduledPin, scheduledLevel);
+}
+
+void hostSchedulePinLevel(uint8_t pin, int level, uint64_t counterUs) {
+    scheduledPin = pin;
+    scheduledLevel = level;
+    hostClockSetAlarm(counterUs, applyScheduledPinLevel);
+}
+
+/* ---------------- SERIAL ---------------- */
+
+HardwareSerial Serial;
+static bool serialEnabled = true;
+static int  serialFd = -1;   // hostSerialAttach()
+
+static size_t serialOut(const void *data, size_t len) {
+    if (serialFd < 0) return fwrite(data, 1, len, stdout);
+    const uint8_t *p = (const uint8_t *)data;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::write(serialFd, p + done, len - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    return done;
+}
+
+void hostSetSerialEnabled(bool enabled) {
+    serialEnabled = enabled;
+}
+
+void HardwareSerial::begin(unsigned long) {}
+
+size_t HardwareSerial::print(const char *s) {
+    if (!serialEnabled) return 0;
+    return serialOut(s, strlen(s));
+}
+
+size_t HardwareSerial::println(const char *s) {
+    size_t n = print(s);
+    return n + print("\n");
+}
+
+size_t HardwareSerial::printf(const char *fmt, ...) {
+    if (!serialEnabled) return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = (serialFd < 0) ? vprintf(fmt, args) : vdprintf(serialFd, fmt, args);
+    va_end(args);
+    return n > 0 ? (size_t)n : 0;
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t len) {
+    if (!serialEnabled) return len;   // sent into the void
+    return serialOut(data, len);
+}
+
+void HardwareSerial::flush() {
+    if (serialFd < 0) fflush(stdout);
+}
+
+// stdout never pushes back; report a roomy UART TX buffer
+int HardwareSerial::availableForWrite() {
+    return 4096;
+}
+
+void HardwareSerial::setTxBufferSize(size_t) {}
+void HardwareSerial::setRxBufferSize(size_t) {}
+
+static std::deque<uint8_t> serialRx;
+
+void hostSerialInject(const char *data, size_t len) {
+    serialRx.insert(serialRx.end(), data, data + len);
+}
+
+void hostSerialAttach(int fd) {
+    serialFd = fd;
+}
+
+// Take in whatever the attached descriptor has ready, without waiting
+static void pullSerialRx() {
+    struct pollfd p = {serialFd, POLLIN, 0};
+    uint8_t buf[4096];
+    while (serialFd >= 0 && poll(&p, 1, 0) > 0 && (p.revents & POLLIN)) {
+        ssize_t n = ::read(serialFd, buf, sizeof(buf));
+        if (n <= 0) break;
+        serialRx.insert(serialRx.end(), buf, buf + n);
+    }
+}
+
+int HardwareSerial::available() {
+    pullSerialRx();
+    return (int)serialRx.size();
+}
+
+int HardwareSerial::read() {
+    if (serialRx.empty()) pullSerialRx();
+    if (serialRx.empty()) return -1;
+    int c = serialRx.front();
+    serialRx.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::read(uint8_t *buffer, size_t size) {
+    if (serialRx.size() < size) pullSerialRx();
+    size_t n = serialRx.size() < size ? serialRx.size() : size;
+    std::copy(serialRx.begin(), serialRx.begin() + n, buffer);
+    serialRx.erase(serialRx.begin(), serialRx.begin() + n);
+    return n;
+}
+
+/* ---------------- FASTLED ---------------- */
+
+CFastLED FastLED;
+
+void CFastLED::addStrip(CRGB *data, int count, uint8_t pin) {
+    strips.push_back(Strip{data, count, pin});
+}
+
+void CFastLED::show() {
+    showCount++;
+
+    if (frames.size() < captureLimit) {
+        HostShownFrame frame;
+        frame.us = getTimeMicros();
+        frame.brightness = brightness;
+        for (const Strip &s : strips) {
+            for (int i = 0; i < s.count; ++i) {
+                const CRGB &c = s.data[i];
+                frame.pixels.push_back(CRGB(scale8(c.r, brightness),
+                                            scale8(c.g, brightness),
+                                            scale8(c.b, brightness)));
+            }
+        }
+        frames.push_back(std::move(frame));
+    }
+
+    // Channels shift out in parallel (30 us/pixel + latch each); show()
+    // returns when the longest one has latched
+    if (hostClockSimulated) hostClockAdvanceMicros(hostShowWireUs());
+}
+
+uint32_t CFastLED::hostChannelWireUs(size_t channel) const {
+    return (uint32_t)strips[channel].count * LED_WIRE_US_PER_PIXEL + LED_LATCH_US;
+}
+
+uint32_t CFastLED::hostShowWireUs() const {
+    uint32_t longest = 0;
+    for (size_t c = 0; c < strips.size(); ++c) {
+        uint32_t us = hostChannelWireUs(c);
+        if (us > longest) longest = us;
+    }
+    return longest;
+}
+
+void CFastLED::clear(bool writeData) {
+    for (const Strip &s : strips) fill_solid(s.data, s.count, CRGB::Black);
+    if (writeData) show();
+}
+
+void CFastLED::hostSetFrameCapture(size_t maxFrames) {
+    captureLimit = maxFrames;
+    frames.clear();
+    frames.reserve(maxFrames < 4096 ? maxFrames : 4096);
+}
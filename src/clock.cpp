@@ -0,0 +1,44 @@
+#include "clock.h"
+
+uint64_t clockEpochMicros = 0;
+
+void initHardwareTimer() {
+    // The counter is already free-running; just remember where we started.
+    clockEpochMicros = readCounterMicros();
+}
+
+#if !defined(ARDUINO)
+std::atomic<bool>     hostClockSimulated(false);
+std::atomic<uint64_t> hostClockSimMicros(0);
+
+void hostClockSetSimulated(bool enabled) {
+    if (enabled && !hostClockSimulated) {
+        hostClockSimMicros = readCounterMicros();   // continue from real time
+    }
+    hostClockSimulated = enabled;
+}
+
+static std::atomic<uint64_t>   hostAlarmUs(0);   // 0 = none pending
+static std::atomic<void (*)()> hostAlarmFn(nullptr);
+
+void hostClockSetAlarm(uint64_t counterUs, void (*fn)()) {
+    hostAlarmFn = fn;
+    hostAlarmUs = counterUs;
+}
+
+bool hostClockAdvanceMicros(uint64_t us, bool stopAtAlarm) {
+    uint64_t now = hostClockSimMicros;
+    uint64_t alarm = hostAlarmUs;
+    if (alarm != 0 && alarm <= now + us && hostAlarmUs.compare_exchange_strong(alarm, 0)) {
+        uint64_t step = (alarm > now) ? alarm - now : 0;
+        hostClockSimMicros += step;
+        us -= step;
+        hostAlarmFn.load()();
+        if (stopAtAlarm) return true;
+        hostClockSimMicros += us;
+        return true;
+    }
+    hostClockSimMicros += us;
+    return false;
+}
+#endif
@@ -0,0 +1,93 @@
+/*
+    ================================================================
+                        SESSION CLOCK (1 μs)
+    ================================================================
+
+    Free-running 64-bit microsecond counter, read directly on every call.
+    There is no periodic tick ISR and no spinlock on the read path.
+
+    • ESP32: esp_timer counter (timer-group LAC, 1 μs resolution, 64-bit,
+      lock-free read that is safe from any core or ISR).
+    • Host builds (no ARDUINO): clock_gettime(CLOCK_MONOTONIC), so the
+      same clock code can be exercised on Linux. The host clock can be
+      switched to a simulated counter that only moves when told to, for
+      deterministic faster-than-real-time runs.
+
+    All readings are relative to the epoch captured by initHardwareTimer().
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ARDUINO)
+#include <esp_timer.h>
+#else
+#include <time.h>
+#include <atomic>
+#endif
+
+// Counter value at initHardwareTimer(); readings are offset by this.
+extern uint64_t clockEpochMicros;
+
+#if !defined(ARDUINO)
+extern std::atomic<bool>     hostClockSimulated;
+extern std::atomic<uint64_t> hostClockSimMicros;
+
+/*
+    Host only: freeze the counter and drive it manually from now on.
+*/
+void hostClockSetSimulated(bool enabled);
+
+/*
+    Host only: run `fn` once when the simulated clock reaches raw counter
+    time `counterUs`. Stands in for an interrupt landing at an exact point
+    of a frame (mid-render, mid-show(), mid-sleep). One pending alarm;
+    setting another replaces it.
+*/
+void hostClockSetAlarm(uint64_t counterUs, void (*fn)());
+
+/*
+    Move the simulated clock forward by `us`, firing a pending alarm at
+    its exact time on the way. With `stopAtAlarm` the advance ends right
+    after the alarm fires. Returns true if the alarm fired.
+*/
+bool hostClockAdvanceMicros(uint64_t us, bool stopAtAlarm = false);
+#endif
+
+/*
+    Raw free-running counter in microseconds (not epoch-adjusted).
+*/
+inline uint64_t readCounterMicros() {
+#if defined(ARDUINO)
+    return (uint64_t)esp_timer_get_time();
+#else
+    if (hostClockSimulated.load(std::memory_order_relaxed)) {
+        return hostClockSimMicros.load(std::memory_order_relaxed);
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+#endif
+}
+
+/*
+    Capture the clock epoch. Keeps the name of the old tick-ISR setup so
+    callers are unchanged; no interrupt is attached any more.
+*/
+void initHardwareTimer();
+
+/*
+    Microseconds since initHardwareTimer(). Wraps after ~584,000 years.
+*/
+inline uint64_t getTimeMicros() {
+    return readCounterMicros() - clockEpochMicros;
+}
+
+/*
+    Seconds since initHardwareTimer(). Float keeps ~60 μs precision after
+    1000 s; use getTimeMicros() where integer precision matters.
+*/
+inline float getTimeSeconds() {
+    return (float)getTimeMicros() * 0.000001f;
+}
@@ -0,0 +1,213 @@
+/*
+    ================================================================
+                    USER-TUNABLE CONFIGURATION
+    ================================================================
+
+    Pins, frequencies, envelopes and safety limits shared by the firmware
+    and the render engine. Edit values here; everything else derives
+    from them.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------- PIN SETTINGS --------------------- */
+#define LED_PIN       12
+#define PANIC_PIN     14     // connect a momentary button to GND
+
+// Data pin of each output strip, driven in parallel on their own RMT
+// channels (led_output.h); the layout says how many are used
+constexpr uint8_t LED_STRIP_PINS[] = { LED_PIN, 13, 27, 26, 25, 33, 32, 4 };
+constexpr int     MAX_LED_STRIPS   = sizeof(LED_STRIP_PINS) / sizeof(LED_STRIP_PINS[0]);
+
+/* ------------------- LED LAYOUT --------------------- */
+// Built-in layouts (topology.cpp): 0 spiral strip, 1 ring goggles
+// (2 x 61), 2 16x16 panel. A custom layout goes in LED_LAYOUTS.
+#ifndef LED_LAYOUT
+#define LED_LAYOUT    0
+#endif
+
+#ifndef NUM_LEDS
+#if LED_LAYOUT == 1
+#define NUM_LEDS      122
+#elif LED_LAYOUT == 2
+#define NUM_LEDS      256
+#else
+#define NUM_LEDS      20     // the strip takes any length: -DNUM_LEDS=300 for benchmarks
+#endif
+#endif
+
+/* ---------------- USER-TUNABLE PARAMETERS -------------- */
+
+// Target theta-range flicker frequencies (4-8 Hz optimal per research).
+// Studies show 5.5-6.5 Hz range is most effective for theta entrainment.
+constexpr float LEFT_FREQ_HZ    = 5.8f;   // Optimized for left hemisphere
+constexpr float RIGHT_FREQ_HZ   = 6.2f;   // Optimized for right hemisphere
+
+// Frequency range for adaptive tuning (if needed in future)
+constexpr float MIN_FREQ_HZ     = 4.0f;
+constexpr float MAX_FREQ_HZ     = 8.0f;
+
+// Optional micro-modulation for texture (fast shimmer).
+// DISABLED by default for cleaner entrainment spectrum.
+constexpr bool  MICRO_ENABLED   = false;
+constexpr float MICRO_FREQ_HZ   = 45.0f;
+
+// Very slow breathing envelope (0.1–0.2 Hz typical for relaxation)
+constexpr float BREATH_FREQ_HZ  = 0.12f;
+
+// Brightness: optimized for safety and effectiveness (research-based)
+constexpr uint8_t GLOBAL_BRIGHTNESS = 70;  // Reduced from 75 for safety
+
+// Frame period for smooth animation (higher FPS = smoother). Frames are
+// scheduled on exact microsecond deadlines, see scheduler.h
+constexpr uint32_t FRAME_PERIOD_US = 10000;   // 100 FPS (improved from 83 FPS)
+
+// Transmit frames from a dedicated output task on another core while the
+// next frame renders (see frame_pipeline.h). false = render and show()
+// back-to-back on the loop core. The native env turns it off so every
+// frame is captured deterministically.
+#ifndef DUAL_CORE_PIPELINE
+#define DUAL_CORE_PIPELINE 1
+#endif
+constexpr bool USE_DUAL_CORE_PIPELINE = DUAL_CORE_PIPELINE;
+constexpr int  OUTPUT_CORE = 0;   // loop() runs on core 1
+
+// Render each frame for the moment it becomes visible instead of its
+// deadline (see presentation.h). Wire timing is for WS2812B at 800 kHz.
+constexpr bool     USE_PRESENTATION_COMPENSATION = true;
+constexpr uint32_t LED_WIRE_US_PER_PIXEL = 30;   // 24 bits x 1.25 us
+constexpr uint32_t LED_LATCH_US = 50;            // reset pulse that latches all pixels
+
+// Apply brightness with per-LED temporal dithering instead of plain
+// scale8 truncation, so slow ramps near black stay smooth (see dither.h).
+#ifndef TEMPORAL_DITHER
+#define TEMPORAL_DITHER 1
+#endif
+constexpr bool USE_TEMPORAL_DITHER = TEMPORAL_DITHER;
+
+// Light output of each LED channel (R, G, B) against PWM duty: light is
+// proportional to duty^gamma. The output stage drives through the inverse
+// (gamma.h), so rendered values stay linear in light. 1.0 = ideal
+// WS2812B; put a photometer fit here or load measured tables at boot.
+constexpr float LED_RESPONSE_GAMMA[3] = { 1.0f, 1.0f, 1.0f };
+
+// Supply current the LEDs may draw, mA (see power.h). Above it the output
+// stage scales the whole frame down smoothly; 0 = no limit. The channel
+// and idle draws are typical WS2812B figures at 5 V: measure your strip.
+#ifndef POWER_LIMIT_MA
+#define POWER_LIMIT_MA 1200
+#endif
+constexpr bool  USE_POWER_LIMITER = POWER_LIMIT_MA > 0;
+constexpr float LED_CHANNEL_MA[3] = { 16.0f, 11.0f, 15.0f };   // R, G, B fully driven
+constexpr float LED_IDLE_MA = 1.0f;                            // per LED, all channels off
+constexpr float POWER_HEADROOM = 0.05f;         // aim this far below: peaks grow cycle to cycle
+constexpr float POWER_RELEASE_SECONDS = 5.0f;   // limiter gain back from 0 to unity
+// Peak memory: one cycle of the running program's slowest modulation,
+// computed with the program (CompiledProgram::holdSeconds, see power.h)
+
+// Per-stage cycle histograms for the frame hot path (see profiler.h).
+// Costs two cycle-counter reads per stage per frame; dump with 'p' over serial.
+// Benchmarks build with -DHOT_PATH_PROFILER=0.
+#ifndef HOT_PATH_PROFILER
+#define HOT_PATH_PROFILER 1
+#endif
+constexpr bool USE_HOT_PATH_PROFILER = HOT_PATH_PROFILER;
+
+// Serial output: 0 = human-readable text, 1 = framed binary telemetry
+// with per-frame records (see telemetry.h; decode with
+// tools/telemetry_decode). Override with -DBINARY_TELEMETRY.
+#ifndef BINARY_TELEMETRY
+#define BINARY_TELEMETRY 0
+#endif
+constexpr bool     USE_BINARY_TELEMETRY   = BINARY_TELEMETRY;
+constexpr uint32_t TELEMETRY_RING_BYTES   = 4096;   // RAM queue, power of two
+constexpr uint32_t SERIAL_TX_BUFFER_BYTES = 1024;   // UART driver TX buffer
+
+// Frame input: 0 = render on the device, 1 = show frames a host streams
+// over serial, each at its presentation time (see frame_stream.h; send
+// with tools/stream_send). The master level, session limit and panic
+// stop apply to streamed frames too. Override with -DFRAME_STREAM.
+#ifndef FRAME_STREAM
+#define FRAME_STREAM 0
+#endif
+constexpr bool     USE_FRAME_STREAM       = FRAME_STREAM;
+constexpr uint32_t STREAM_BAUD            = 2000000;   // ~200 kB/s: 2 kB frames at 100 FPS
+constexpr int      STREAM_RING_FRAMES     = 16;        // preallocated frame buffers
+constexpr uint32_t STREAM_PREROLL_US      = 50000;     // first frame shows this long after arrival
+constexpr uint32_t SERIAL_RX_BUFFER_BYTES = 8192;      // UART driver RX buffer (stream mode)
+
+// Interval for the late/dropped frame summary on serial
+constexpr uint32_t STATS_REPORT_SECONDS = 60;
+
+// Smooth fade-in to prevent abrupt onset (critical for safety)
+constexpr float RAMP_IN_SECONDS = 180.0f;  // 3 minutes (increased for comfort)
+
+// Hard safety limit: after this time the device fades to black
+constexpr float MAX_SESSION_SECONDS = 1800.0f;  // 30 minutes (research-recommended max)
+constexpr float FADE_OUT_SECONDS = 15.0f;       // then fade to black over this long
+
+// Switch mandala mode every 30 seconds (prevents adaptation)
+constexpr float MODE_DURATION = 30.0f;
+
+// Reflection/echo effect to enrich visuals (reduced for cleaner signal)
+constexpr int   REFLECTION_OFFSET = 2;  // Reduced from 3
+constexpr float REFLECTION_DECAY  = 0.35f;  // Reduced from 0.45f
+
+// SHARPNESS lowered to avoid excessive high-frequency harmonics
+constexpr float PULSE_SHARPNESS = 2.5f;  // Reduced from 3.0f
+
+// Recommended sinusoidal modulation to reduce harmonics (research-proven)
+constexpr bool  USE_SINUSOIDAL_MODULATION = true;
+
+// Phase synchronization enhancement (for better entrainment)
+constexpr bool  USE_PHASE_ENHANCEMENT = true;
+constexpr float PHASE_SYNC_STRENGTH = 0.15f;
+
+// Print trig backend accuracy and cycle cost at boot (see trig.h;
+// select the backend with -DTRIG_USE_LUT=0/1 in platformio.ini).
+// Override with -DPRINT_TRIG_REPORT=1.
+#ifndef PRINT_TRIG_REPORT
+#define PRINT_TRIG_REPORT 0
+#endif
+
+// Per-LED render pipeline: 0 = float reference, 1 = integer-only Q15
+// (see render.h). Override with -DRENDER_FIXED_POINT in platformio.ini.
+#ifndef RENDER_FIXED_POINT
+#define RENDER_FIXED_POINT 0
+#endif
+
+// Session timeline (see session_program.h): 0 = the fixed protocol
+// above, 1 = linear 8 Hz -> 6 Hz descent, 2 = exponential descent.
+// Override with -DSESSION_PROGRAM.
+#ifndef SESSION_PROGRAM
+#define SESSION_PROGRAM 0
+#endif
+constexpr int ACTIVE_SESSION_PROGRAM = SESSION_PROGRAM;
+constexpr int MAX_PROGRAM_RECORDS    = 128;   // compiled records kept in RAM (~160 B each)
+
+// Exponential sweeps are compiled into linear chirp pieces; this is the
+// largest allowed relative frequency error of that approximation.
+constexpr float EXP_SWEEP_TOLERANCE = 1e-4f;
+
+/* ---------------- DERIVED OSCILLATOR RATES ---------------- */
+
+// Carrier for the radial petals: midpoint of the two eye frequencies
+constexpr float carrierHz(float leftHz, float rightHz) { return (leftHz + rightHz) * 0.5f; }
+
+// Spiral sweep speeds (turns per second) for the cores and main body
+constexpr float spiralCoreSpeed(float eyeHz)     { return 0.25f + eyeHz * 0.02f; }
+constexpr float spiralBodySpeed(float carrierHz) { return 0.3f + 0.02f * carrierHz; }
+
+// Period of the slowest modulation at these eye frequencies: the
+// breathing envelope, or the L/R beat if that is slower still
+constexpr float slowestModulationSeconds(float leftHz, float rightHz) {
+    float beatHz = (leftHz > rightHz) ? leftHz - rightHz : rightHz - leftHz;
+    return (beatHz > 0.0f && beatHz < BREATH_FREQ_HZ) ? 1.0f / beatHz : 1.0f / BREATH_FREQ_HZ;
+}
+
+constexpr float CARRIER_FREQ_HZ    = carrierHz(LEFT_FREQ_HZ, RIGHT_FREQ_HZ);
+constexpr float SPIRAL_LEFT_SPEED  = spiralCoreSpeed(LEFT_FREQ_HZ);
+constexpr float SPIRAL_RIGHT_SPEED = spiralCoreSpeed(RIGHT_FREQ_HZ);
+constexpr float SPIRAL_BODY_SPEED  = spiralBodySpeed(CARRIER_FREQ_HZ);
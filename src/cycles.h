@@ -0,0 +1,53 @@
+/*
+    CPU cycle counter for micro-benchmarks and diagnostics.
+    ESP32: Xtensa CCOUNT (core clock, wraps every ~17.9 s at 240 MHz).
+    Host: x86 TSC, or steady_clock nanoseconds elsewhere.
+    Only use the difference of two nearby readings.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ARDUINO)
+#include <esp32-hal-cpu.h>
+#include <xtensa/core-macros.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <chrono>
+#else
+#include <chrono>
+#endif
+
+inline uint32_t readCycleCounter() {
+#if defined(ARDUINO)
+    return (uint32_t)XTHAL_GET_CCOUNT();
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/*
+    Counter rate in Hz, for turning cycle counts into time. The TSC rate is
+    calibrated once against steady_clock (~20 ms busy wait, first call).
+*/
+inline uint64_t cycleCounterHz() {
+#if defined(ARDUINO)
+    return (uint64_t)getCpuFrequencyMhz() * 1000000u;
+#elif defined(__x86_64__) || defined(__i386__)
+    static const uint64_t hz = [] {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = __rdtsc();
+        while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(20)) {}
+        uint64_t c1 = __rdtsc();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return (uint64_t)((double)(c1 - c0) / s);
+    }();
+    return hz;
+#else
+    return 1000000000u;
+#endif
+}
@@ -0,0 +1,81 @@
+/*
+    ================================================================
+                  DDS PHASE ACCUMULATORS (drift-free)
+    ================================================================
+
+    Direct-digital-synthesis oscillator. Phase is a Q0.64 fraction of one
+    cycle (2^64 == one full turn) advanced by an integer increment per
+    elapsed microsecond. Unsigned wrap-around is the modulo, so the
+    accumulated phase is exact integer arithmetic: splitting a session into
+    any number of advance() steps gives the same phase as one big step,
+    for hours or days. Changing the frequency only swaps the increment, so
+    phase stays continuous across the change.
+
+    Frequency resolution is 1e6 / 2^64 Hz (~5e-14 Hz).
+
+    A linear chirp adds a constant change to the increment every
+    microsecond. Phase is then the exact discrete sum
+    inc*n + chirp*n(n-1)/2, which is also independent of how the time is
+    split into advance() steps.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// 2^64 / 1e6: Q0.64 turns per microsecond at 1 Hz.
+constexpr double DDS_TURNS_PER_US_AT_1HZ = 18446744073709551616.0 / 1000000.0;
+
+/*
+    Q0.64 phase increment per microsecond for a frequency in Hz.
+    Valid for 0 <= freqHz < 1 MHz.
+*/
+constexpr uint64_t ddsIncrement(double freqHz) {
+    return (uint64_t)(freqHz * DDS_TURNS_PER_US_AT_1HZ);
+}
+
+struct Oscillator {
+    uint64_t phase    = 0;   // Q0.64 turns
+    uint64_t incPerUs = 0;   // Q0.64 turns per microsecond
+    uint64_t lastUs   = 0;   // timestamp of the last advance/seek
+    int64_t  chirpPerUs = 0; // increment change per microsecond (linear chirp)
+
+    void setFrequency(double freqHz) {
+        incPerUs = ddsIncrement(freqHz);
+    }
+
+    /*
+        Jump to absolute time `us` assuming the current frequency has been
+        constant since t = 0 (phase 0 at t = 0).
+    */
+    void seek(uint64_t us) {
+        phase  = incPerUs * us;
+        lastUs = us;
+    }
+
+    /*
+        Accumulate phase up to `nowUs`. Multiplication wraps mod 2^64,
+        which is exactly the modulo-one-turn we want.
+    */
+    void advanceTo(uint64_t nowUs) {
+        uint64_t n = nowUs - lastUs;
+        phase += incPerUs * n;
+        if (chirpPerUs != 0) {
+            // n(n-1)/2 without overflow: halve whichever factor is even
+            uint64_t tri = (n & 1) ? n * ((n - 1) >> 1) : (n >> 1) * (n - 1);
+            phase    += (uint64_t)chirpPerUs * tri;
+            incPerUs += (uint64_t)chirpPerUs * n;
+        }
+        lastUs = nowUs;
+    }
+
+    // Top 32 bits: Q0.32 turns, suitable for table lookups.
+    uint32_t phaseQ32() const {
+        return (uint32_t)(phase >> 32);
+    }
+
+    // Phase in 0..1 with full float (24-bit) precision.
+    float phase01() const {
+        return (float)(phase >> 40) * (1.0f / 16777216.0f);
+    }
+};
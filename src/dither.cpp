@@ -0,0 +1,27 @@
+#include "dither.h"
+
+#include "gamma.h"
+
+static_assert(sizeof(CRGB) == 3, "frames are walked as packed bytes");
+
+void TemporalDither::reset() {
+    // 0.618 LSB apart (golden ratio), so no two neighbours start in step
+    for (int k = 0; k < NUM_LEDS * 3; ++k) residual[k] = (uint8_t)(k * 158u);
+}
+
+OutputLoad TemporalDither::apply(const OutputCurve &curve, CRGB *leds, uint32_t master) {
+    uint8_t *bytes = (uint8_t *)leds;
+    uint8_t *res = residual;
+    uint32_t sum[3] = {0, 0, 0};
+    for (int i = 0; i < NUM_LEDS; ++i, bytes += 3, res += 3) {
+        for (int c = 0; c < 3; ++c) {
+            uint16_t drive = (uint16_t)((curve.level[c][bytes[c]] * master) >> 16);
+            sum[c] += drive;
+            // At most 255 + OUTPUT_LEVEL_MAX = 65535: fits the 16-bit accumulator
+            uint16_t acc = res[c] + drive;
+            bytes[c] = (uint8_t)(acc >> 8);
+            res[c] = (uint8_t)acc;
+        }
+    }
+    return OutputLoad{{sum[0], sum[1], sum[2]}};
+}
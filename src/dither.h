@@ -0,0 +1,49 @@
+/*
+    ================================================================
+                   TEMPORAL DITHERING (output stage)
+    ================================================================
+
+    The output curve and the master level (gamma.h) turn each 8-bit
+    render value into a 16-bit drive level in 1/256 LSB, v · 71 for a
+    linear LED at GLOBAL_BRIGHTNESS 70. Truncating that to the byte on
+    the wire leaves only ~70 levels, so the last seconds of the ramp-in and
+    the fade-out creep through a handful of steps near black, and each
+    step is a spurious low-frequency flicker component.
+
+    Instead every channel of every LED keeps a 16-bit accumulator: the
+    drive level is added to the residual left over from earlier frames,
+    the top byte goes on the wire and the low byte carries on. The mean
+    output follows the 16-bit level exactly; the error is first-order
+    noise shaped (1 - z⁻¹), so its power density peaks at the 50 Hz frame
+    Nyquist and is ~15 dB lower at 6 Hz, ~36 dB at 0.5 Hz. Residuals start
+    staggered across LEDs so a slow level does not toggle every LED in
+    the same frame. A zero level always sends zero: black stays black.
+
+    tools/dither_check measures the error spectrum over the ramp and the
+    fade, with and without dithering.
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "gamma.h"
+
+struct TemporalDither {
+    // Each channel accumulates in 16 bits; only the low byte carries over
+    uint8_t residual[NUM_LEDS * 3];
+
+    TemporalDither() { reset(); }
+
+    // Staggered start residuals
+    void reset();
+
+    /*
+        Drive `leds` through `curve` at `master` (Q16, outputMaster()), in
+        place, into the bytes to send (at FastLED brightness 255). Called
+        once per shown frame. Returns the drive totals before dithering.
+    */
+    OutputLoad apply(const OutputCurve &curve, CRGB *leds, uint32_t master);
+};
@@ -0,0 +1,42 @@
+/*
+    Saturating Q15 helpers for the integer render pipeline.
+
+    Values are held in int32_t with 1.0 == 32768, so unity is exactly
+    representable and intermediate sums have headroom. Products of two
+    operands in [-1, 1] fit in 32 bits.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int32_t q15_t;
+
+constexpr q15_t Q15_ONE = 32768;
+
+constexpr q15_t q15FromFloat(float v) {
+    return (q15_t)(v * (float)Q15_ONE + (v >= 0.0f ? 0.5f : -0.5f));
+}
+
+// Float 0..1 -> Q15 with saturation (per-frame boundary conversions).
+inline q15_t q15FromUnit(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return Q15_ONE;
+    return (q15_t)(v * (float)Q15_ONE);
+}
+
+// a * b for |a|, |b| <= 1.0
+inline q15_t q15Mul(q15_t a, q15_t b) {
+    return (a * b) >> 15;
+}
+
+inline q15_t q15Sat01(q15_t v) {
+    if (v < 0) return 0;
+    if (v > Q15_ONE) return Q15_ONE;
+    return v;
+}
+
+// 8-bit channel scaled by a 0..1 Q15 amplitude (truncating, like the float path)
+inline uint8_t q15ScaleU8(uint8_t c, q15_t amp) {
+    return (uint8_t)(((int32_t)c * amp) >> 15);
+}
@@ -0,0 +1,155 @@
+#include "frame_pipeline.h"
+
+#include <string.h>
+
+#include "clock.h"
+#include "led_output.h"
+#include "panic.h"
+#include "presentation.h"
+#include "profiler.h"
+
+#if defined(ARDUINO)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+static FrameSlot   slot;
+static OutputStats outputStats;
+static CRGB       *outputLeds = nullptr;
+
+static void atomicMax(std::atomic<uint32_t> &a, uint32_t v) {
+    uint32_t cur = a.load(std::memory_order_relaxed);
+    while (v > cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+/*
+    Transmit the newest published frame, if any. After a panic stop every
+    wake-up sends black, published frame or not.
+*/
+static void showLatestFrame() {
+    if (!slot.acquire() && !panicActive()) return;
+    PipelineFrame &f = slot.frontBuffer();
+
+    memcpy(outputLeds, f.leds, sizeof(f.leds));
+    bool blanked = panicBlankFrame(outputLeds);
+
+    uint64_t t0 = getTimeMicros();
+    recordShowStart(f.tick.idealUs, t0);
+    uint32_t c0 = profileStamp();
+    ledOutputShow(f.master);
+    profileSince(PROF_SHOW, c0);
+    uint64_t t1 = getTimeMicros();
+    if (blanked) panicFrameDark();
+
+    outputStats.shown.fetch_add(1, std::memory_order_relaxed);
+    atomicMax(outputStats.maxShowUs, (uint32_t)(t1 - t0));
+    if (t0 > f.tick.idealUs) atomicMax(outputStats.maxQueueUs, (uint32_t)(t0 - f.tick.idealUs));
+}
+
+/* ---------------- PLATFORM TASKS ---------------- */
+
+#if defined(ARDUINO)
+
+static TaskHandle_t outputTask = nullptr;
+
+static void outputTaskMain(void *) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        showLatestFrame();
+    }
+}
+
+void startOutputPipeline(CRGB *outLeds) {
+    outputLeds = outLeds;
+    xTaskCreatePinnedToCore(outputTaskMain, "led-out", 4096, nullptr,
+                            configMAX_PRIORITIES - 2, &outputTask, OUTPUT_CORE);
+}
+
+void stopOutputPipeline() {}
+
+static void wakeOutput() {
+    xTaskNotifyGive(outputTask);
+}
+
+void IRAM_ATTR pipelineWakeFromIsr() {
+    if (outputTask == nullptr) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(outputTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+#else
+
+static std::thread             outputThread;
+static std::mutex              wakeMutex;
+static std::condition_variable wakeCv;
+static bool                    wakePending = false;
+static bool                    stopRequested = false;
+
+static void outputThreadMain() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCv.wait(lock, [] { return wakePending || stopRequested; });
+            if (!wakePending) return;   // stopped, nothing left to send
+            wakePending = false;
+        }
+        showLatestFrame();
+    }
+}
+
+void startOutputPipeline(CRGB *outLeds) {
+    outputLeds = outLeds;
+    stopRequested = false;
+    outputThread = std::thread(outputThreadMain);
+}
+
+void stopOutputPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = true;
+    }
+    wakeCv.notify_one();
+    if (outputThread.joinable()) outputThread.join();
+}
+
+// The mutex only guards the wake flag; frame data goes through FrameSlot.
+static void wakeOutput() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakePending = true;
+    }
+    wakeCv.notify_one();
+}
+
+// Host "ISRs" run in whichever thread advanced the clock, so the
+// ordinary wake-up is fine
+void pipelineWakeFromIsr() {
+    wakeOutput();
+}
+
+#endif
+
+/* ---------------- PRODUCER API ---------------- */
+
+PipelineFrame &pipelineBackBuffer() {
+    return slot.backBuffer();
+}
+
+void pipelinePublish() {
+    slot.publish();
+    wakeOutput();
+}
+
+uint32_t pipelineOverwritten() {
+    return slot.overwritten.load(std::memory_order_relaxed);
+}
+
+const OutputStats &pipelineOutputStats() {
+    return outputStats;
+}
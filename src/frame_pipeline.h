@@ -0,0 +1,102 @@
+/*
+    ================================================================
+                 RENDER / OUTPUT PIPELINE (two cores)
+    ================================================================
+
+    The render task fills frame N+1 while a dedicated output task
+    transmits frame N with FastLED.show(), so strip transmit time no
+    longer adds to render time.
+
+      render task (loop, core 1)            output task (OUTPUT_CORE)
+      ───────────────────────────           ──────────────────────────
+      renderFrame(pipelineBackBuffer())
+      pipelinePublish()  ──── FrameSlot ──► acquire latest frame
+                                            copy to leds[], show()
+
+    FrameSlot is a lock-free single-producer/single-consumer triple
+    buffer: the producer always owns one buffer, the consumer owns one,
+    and the third sits in an atomic "shared" slot. Neither side ever
+    waits for the other. If the producer publishes twice before the
+    consumer picks up, the older frame is replaced and counted as
+    overwritten.
+
+    Host builds map the output task to a std::thread, so the handoff can
+    be stress-tested under ThreadSanitizer.
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "config.h"
+#include "scheduler.h"
+
+struct PipelineFrame {
+    CRGB      leds[NUM_LEDS];
+    FrameTick tick;
+    uint32_t  master;   // Q16 output level, outputMaster()
+};
+
+struct FrameSlot {
+    static constexpr uint32_t FRESH = 0x4;   // set while the shared buffer is unread
+    static constexpr uint32_t INDEX = 0x3;
+
+    PipelineFrame buffers[3];
+    std::atomic<uint32_t> shared{2};
+    uint32_t back  = 0;   // producer-owned
+    uint32_t front = 1;   // consumer-owned
+    std::atomic<uint32_t> overwritten{0};
+
+    PipelineFrame &backBuffer() { return buffers[back]; }
+    PipelineFrame &frontBuffer() { return buffers[front]; }
+
+    /*
+        Producer: hand the back buffer over, take the shared one back.
+    */
+    void publish() {
+        uint32_t prev = shared.exchange(back | FRESH, std::memory_order_acq_rel);
+        if (prev & FRESH) overwritten.fetch_add(1, std::memory_order_relaxed);
+        back = prev & INDEX;
+    }
+
+    /*
+        Consumer: swap in the newest frame. False if nothing new.
+    */
+    bool acquire() {
+        if (!(shared.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint32_t prev = shared.exchange(front, std::memory_order_acq_rel);
+        front = prev & INDEX;
+        return true;
+    }
+};
+
+struct OutputStats {
+    std::atomic<uint32_t> shown{0};       // frames transmitted
+    std::atomic<uint32_t> maxShowUs{0};   // longest FastLED.show()
+    std::atomic<uint32_t> maxQueueUs{0};  // worst publish -> show start, from ideal time
+};
+
+/*
+    Spawn the output task. `outLeds` is the array registered with
+    initLedOutput(); frames are copied into it before each show().
+*/
+void startOutputPipeline(CRGB *outLeds);
+
+/*
+    Host only: stop and join the output thread (no-op on target).
+*/
+void stopOutputPipeline();
+
+PipelineFrame &pipelineBackBuffer();
+void pipelinePublish();
+
+/*
+    Wake the output task without publishing, e.g. so it blanks the strip
+    after a panic edge. Callable from an ISR.
+*/
+void pipelineWakeFromIsr();
+
+uint32_t pipelineOverwritten();
+const OutputStats &pipelineOutputStats();
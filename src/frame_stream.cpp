@@ -0,0 +1,196 @@
+#include "frame_stream.h"
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "config.h"
+#include "telemetry.h"
+
+static_assert((STREAM_RING_FRAMES & (STREAM_RING_FRAMES - 1)) == 0, "ring size must be a power of two");
+
+// A STREAM_FRAME payload lands here as sent: header, then the pixels
+struct StreamSlot {
+    StreamFrameHeader info;
+    CRGB              leds[NUM_LEDS];
+    bool              end;    // STREAM_END marker, no pixels
+};
+
+static_assert(sizeof(CRGB) == 3 && offsetof(StreamSlot, leds) == sizeof(StreamFrameHeader),
+              "stream payload must map onto StreamSlot");
+
+static StreamSlot  ring[STREAM_RING_FRAMES];
+static uint32_t    ringHead = 0;   // next slot filled (free-running)
+static uint32_t    ringTail = 0;   // oldest slot in use: the frame on show, if any
+static StreamStats stats = {};
+
+static StreamSlot &slot(uint32_t i) {
+    return ring[i & (STREAM_RING_FRAMES - 1)];
+}
+
+void initFrameStream() {
+    Serial.setRxBufferSize(SERIAL_RX_BUFFER_BYTES);
+}
+
+const StreamStats &streamStats() {
+    return stats;
+}
+
+/* ---------------- RECEIVER ---------------- */
+
+enum RxState : uint8_t { RX_SYNC0, RX_SYNC1, RX_HEADER, RX_PAYLOAD, RX_CRC };
+
+static RxState  rxState = RX_SYNC0;
+static uint8_t  rxHeader[STREAM_HEADER_BYTES - 2];   // type, reserved, len
+static uint8_t  rxTrailer[STREAM_CRC_BYTES];
+static uint8_t  rxKey = 0;
+static uint8_t *rxDest = nullptr;   // where the payload goes; null until a slot is free
+static uint32_t rxLen = 0;
+static uint32_t rxGot = 0;          // bytes of the current field so far
+static uint32_t lastPresentUs = 0;
+
+// Read toward `len` bytes at `dst`; true once the field is complete
+static bool fill(uint8_t *dst, uint32_t len) {
+    while (rxGot < len) {
+        int avail = Serial.available();
+        if (avail <= 0) return false;
+        uint32_t n = len - rxGot;
+        if (n > (uint32_t)avail) n = (uint32_t)avail;
+        rxGot += (uint32_t)Serial.read(dst + rxGot, n);
+    }
+    rxGot = 0;
+    return true;
+}
+
+static bool validHeader() {
+    uint32_t len = rxHeader[2] | (uint32_t)rxHeader[3] << 8;
+    switch (rxHeader[0]) {
+        case STREAM_FRAME: return len == STREAM_FRAME_PAYLOAD;
+        case STREAM_END:   return len == sizeof(StreamFrameHeader);
+        case STREAM_KEY:   return len == 1;
+        default:           return false;
+    }
+}
+
+static void finishPacket(void (*onKey)(int)) {
+    uint16_t crc = crc16Update(CRC16_INIT, rxHeader, sizeof(rxHeader));
+    crc = crc16Update(crc, rxDest, (int)rxLen);
+    bool ok = crc == (uint16_t)(rxTrailer[0] | rxTrailer[1] << 8);
+
+    if (ok && rxHeader[0] == STREAM_KEY) {
+        onKey(rxKey);
+        return;
+    }
+    // Frames must move forward; a repeat would never be shown
+    StreamSlot &s = slot(ringHead);
+    if (ok && stats.received > 0) ok = (int32_t)(s.info.presentUs - lastPresentUs) > 0;
+    if (!ok) {
+        stats.rejected++;
+        return;
+    }
+    s.end = rxHeader[0] == STREAM_END;
+    lastPresentUs = s.info.presentUs;
+    ringHead++;
+    stats.received++;
+}
+
+void streamReceive(void (*onKey)(int)) {
+    for (;;) {
+        switch (rxState) {
+            case RX_SYNC0:
+            case RX_SYNC1: {
+                int c = Serial.read();
+                if (c < 0) return;
+                if (c == STREAM_SYNC0)                            rxState = RX_SYNC1;
+                else if (rxState == RX_SYNC1 && c == STREAM_SYNC1) rxState = RX_HEADER;
+                else                                              rxState = RX_SYNC0;
+                break;
+            }
+            case RX_HEADER:
+                if (!fill(rxHeader, sizeof(rxHeader))) return;
+                if (!validHeader()) {
+                    stats.rejected++;
+                    rxState = RX_SYNC0;
+                    break;
+                }
+                rxLen = rxHeader[2] | (uint32_t)rxHeader[3] << 8;
+                rxDest = (rxHeader[0] == STREAM_KEY) ? &rxKey : nullptr;
+                rxState = RX_PAYLOAD;
+                break;
+
+            case RX_PAYLOAD:
+                if (rxDest == nullptr) {
+                    // Ring full: leave the bytes in the UART buffer for now
+                    if (ringHead - ringTail == STREAM_RING_FRAMES) return;
+                    rxDest = (uint8_t *)&slot(ringHead);
+                }
+                if (!fill(rxDest, rxLen)) return;
+                rxState = RX_CRC;
+                break;
+
+            case RX_CRC:
+                if (!fill(rxTrailer, sizeof(rxTrailer))) return;
+                finishPacket(onKey);
+                rxState = RX_SYNC0;
+                break;
+        }
+    }
+}
+
+/* ---------------- PRESENTATION ---------------- */
+
+static bool    started = false;   // epoch set by the first frame
+static bool    onShow = false;    // slot(ringTail) is the frame on the strip
+static bool    dry = false;       // in an underrun
+static int64_t epochUs = 0;       // session time of the host's presentUs 0
+
+static int64_t dueUs(const StreamSlot &s) {
+    return epochUs + s.info.presentUs;
+}
+
+static void pickFrame(uint64_t sessionUs) {
+    const int64_t now = (int64_t)sessionUs;
+    uint32_t first = ringTail + (onShow ? 1 : 0);
+    uint32_t queued = ringHead - first;
+    if (queued > stats.maxQueued) stats.maxQueued = queued;
+
+    // Due by the deadline nearest its presentation time
+    uint32_t next = first;
+    while (next != ringHead && dueUs(slot(next)) < now + FRAME_PERIOD_US / 2) ++next;
+
+    if (next == first) {
+        if (!onShow) return;   // pre-roll
+        stats.held++;
+        if (queued == 0) {
+            stats.underruns++;
+            if (!dry) telemetryEvent(TELEM_EVENT_UNDERRUN, (uint32_t)(sessionUs / 1000));
+            dry = true;
+        }
+        return;
+    }
+
+    uint32_t newest = next - 1;
+    stats.skipped += newest - first;
+    if (dueUs(slot(newest)) < now - (int64_t)FRAME_PERIOD_US / 2) stats.late++;
+    if (!slot(newest).end) stats.shown++;
+    ringTail = newest;   // frees everything before it
+    onShow = true;
+    dry = false;
+}
+
+bool streamFrame(uint64_t sessionUs, CRGB *leds) {
+    if (!started && ringHead != ringTail) {
+        started = true;
+        epochUs = (int64_t)sessionUs + STREAM_PREROLL_US - slot(ringTail).info.presentUs;
+    }
+    if (started) pickFrame(sessionUs);
+
+    if (!onShow) {
+        fill_solid(leds, NUM_LEDS, CRGB::Black);
+        return true;
+    }
+    const StreamSlot &s = slot(ringTail);
+    if (s.end) return false;
+    memcpy(leds, s.leds, sizeof(s.leds));
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+    ================================================================
+                 STREAMED FRAME INPUT (FRAME_STREAM mode)
+    ================================================================
+
+    The device as a timed display: a host renders the frames and sends
+    them over the UART (stream_format.h, tools/stream_send), and the
+    render loop shows each one on the deadline it was stamped for,
+    instead of rendering its own.
+
+      UART RX ──► streamReceive() ──► ring of STREAM_RING_FRAMES
+                  (loop task, never     preallocated frame buffers
+                   blocks)                       │
+      deadline ──► streamFrame() ── newest due frame ──► frameBuffer()
+
+    Packets are read straight into the next free ring slot and checked
+    there; nothing is staged in between. The frame on the strip stays in
+    its slot until a newer one is due, so the only copy per deadline is
+    the one into the strip buffer that renderFrame() would have filled.
+
+    Timing: the first frame anchors the host's presentUs clock so that it
+    shows STREAM_PREROLL_US after it arrived; every later frame is due
+    at its own presentUs on that clock, on the nearest frame deadline.
+    Per deadline:
+
+      newest due frame      shown; older due frames still waiting are
+                            skipped, and it counts as late if its own
+                            deadline has already passed
+      none due              the previous frame is held; with no frame
+                            waiting at all the stream has run dry, an
+                            underrun (telemetry event at the first one)
+
+    Nothing is shown until the first frame is due (the strip stays
+    black). The host must keep no more than STREAM_RING_FRAMES - 1
+    frames ahead: a full ring leaves further bytes in the UART driver's
+    buffer, and once that overflows packets are lost (and rejected).
+
+    The output pass (curve, master level, dither, power limiter), the
+    session time limit and fade, and the panic stop are the render
+    loop's as for rendered frames. Ramp-in is up to the host.
+
+    Loop task only, like the telemetry ring.
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+
+#include "stream_format.h"
+
+struct StreamStats {
+    uint32_t received;    // frames accepted into the ring
+    uint32_t rejected;    // packets dropped: bad CRC, length, type or timestamp
+    uint32_t shown;       // frames put on the strip
+    uint32_t late;        // shown after their own deadline
+    uint32_t skipped;     // superseded before they were shown
+    uint32_t held;        // deadlines that repeated the frame on show
+    uint32_t underruns;   // of those, deadlines with no frame waiting at all
+    uint32_t maxQueued;   // most frames waiting to be shown
+};
+
+/*
+    Size the UART RX buffer; call before Serial.begin().
+*/
+void initFrameStream();
+
+/*
+    Move whatever the UART has received into the ring without blocking.
+    STREAM_KEY packets go to `onKey`. Call before streamFrame().
+*/
+void streamReceive(void (*onKey)(int));
+
+/*
+    Fill `leds` with the frame to show at session time `sessionUs` (the
+    moment it becomes visible): the newest due frame, or the one already
+    on show, or black before the first. False once the host's
+    STREAM_END is due; `leds` is then untouched.
+*/
+bool streamFrame(uint64_t sessionUs, CRGB *leds);
+
+const StreamStats &streamStats();
@@ -0,0 +1,37 @@
+#include "gamma.h"
+
+constexpr OutputCurve MODEL_CURVE = makeOutputCurve(LED_RESPONSE_GAMMA);
+
+static_assert(MODEL_CURVE.level[0][255] == OUTPUT_LEVEL_MAX && MODEL_CURVE.level[1][255] == OUTPUT_LEVEL_MAX &&
+              MODEL_CURVE.level[2][255] == OUTPUT_LEVEL_MAX, "full scale maps to full drive");
+
+// In RAM: read for every byte of every frame, and replaceable at boot
+static OutputCurve curve = MODEL_CURVE;
+
+const OutputCurve &outputCurve() {
+    return curve;
+}
+
+bool loadOutputCurve(int c, const uint16_t level[256]) {
+    if (c < 0 || c >= 3 || level[0] != 0) return false;
+    for (int v = 1; v < 256; ++v) {
+        if (level[v] < level[v - 1] || level[v] > OUTPUT_LEVEL_MAX) return false;
+    }
+    for (int v = 0; v < 256; ++v) curve.level[c][v] = level[v];
+    return true;
+}
+
+static_assert((uint64_t)OUTPUT_LEVEL_MAX * OUTPUT_MASTER_FULL < (1ull << 32), "output product overflows");
+
+OutputLoad applyOutputCurve(const OutputCurve &curve, CRGB *leds, uint32_t master) {
+    uint8_t *bytes = (uint8_t *)leds;
+    uint32_t sum[3] = {0, 0, 0};
+    for (int i = 0; i < NUM_LEDS; ++i, bytes += 3) {
+        for (int c = 0; c < 3; ++c) {
+            uint32_t drive = (curve.level[c][bytes[c]] * master) >> 16;
+            sum[c] += drive;
+            bytes[c] = (uint8_t)(drive >> 8);
+        }
+    }
+    return OutputLoad{{sum[0], sum[1], sum[2]}};
+}
@@ -0,0 +1,121 @@
+/*
+    ================================================================
+                OUTPUT CURVE (LED luminance linearisation)
+    ================================================================
+
+    Rendered channel values are linear in light: the modulation, masks
+    and envelopes are all computed as light amplitudes. An LED channel
+    whose light output is not proportional to its PWM duty bends every
+    sine on the way out and shifts the flicker depth. The output stage
+    therefore drives each channel through the inverse of its response.
+
+    The response is light ∝ duty^γ per channel (LED_RESPONSE_GAMMA in
+    config.h). makeOutputCurve() turns it into one 256-entry table per
+    channel at compile time: rendered byte -> drive level in 1/256 LSB,
+    16 bits, level[c][255] = 255 · 256. The output pass multiplies that
+    by the master level (Q16, sessionLevel()) and either dithers it
+    (dither.h) or truncates it to the byte on the wire. Measured tables
+    (a photometer sweep) can replace the model at boot with
+    loadOutputCurve().
+
+    With γ = 1 every table is v · 256 and the output is byte-identical
+    to plain scale8(). tools/gamma_bench times the table pass against
+    per-pixel powf().
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+
+#include "config.h"
+
+constexpr uint16_t OUTPUT_LEVEL_MAX   = 255 * 256;   // level of byte 255, full drive
+constexpr uint32_t OUTPUT_MASTER_FULL = 1u << 16;    // master multiplier of full drive
+
+// A 0..1 master level as the output pass's Q16 multiplier
+inline uint32_t outputMaster(float level) {
+    if (level <= 0.0f) return 0;
+    if (level >= 1.0f) return OUTPUT_MASTER_FULL;
+    return (uint32_t)(level * (float)OUTPUT_MASTER_FULL + 0.5f);
+}
+
+struct OutputCurve {
+    uint16_t level[3][256];   // [channel R, G, B][rendered byte]
+};
+
+/*
+    What one output pass drove, per channel: the sum of its drive levels
+    after the master level, OUTPUT_LEVEL_MAX per fully driven channel.
+    The power estimate (power.h) is built from it.
+*/
+struct OutputLoad {
+    uint32_t drive[3];   // R, G, B
+};
+
+static_assert((uint64_t)NUM_LEDS * OUTPUT_LEVEL_MAX < (1ull << 32), "drive totals overflow");
+
+/* ---------------- COMPILE-TIME GENERATION ---------------- */
+
+// constexpr ln / exp, accurate to ~1e-15 over the table's range
+constexpr double cxLn(double x) {
+    constexpr double LN2 = 0.69314718055994530942;
+    int k = 0;
+    while (x > 2.0) { x *= 0.5; k++; }
+    while (x < 1.0) { x *= 2.0; k--; }
+    // ln x = 2 atanh(y), y = (x - 1) / (x + 1) <= 1/3
+    double y = (x - 1.0) / (x + 1.0), y2 = y * y, term = y, sum = 0.0;
+    for (int n = 0; n < 40; ++n) {
+        sum += term / (2 * n + 1);
+        term *= y2;
+    }
+    return 2.0 * sum + k * LN2;
+}
+
+constexpr double cxExp(double x) {
+    constexpr double LN2 = 0.69314718055994530942;
+    int k = (int)(x / LN2 + (x >= 0.0 ? 0.5 : -0.5));
+    double r = x - k * LN2, term = 1.0, sum = 1.0;
+    for (int n = 1; n < 30; ++n) {
+        term *= r / n;
+        sum += term;
+    }
+    for (; k > 0; --k) sum *= 2.0;
+    for (; k < 0; ++k) sum *= 0.5;
+    return sum;
+}
+
+/*
+    Tables for LEDs whose channel light is duty^gamma[c]:
+    level = OUTPUT_LEVEL_MAX · (v / 255)^(1 / gamma[c]), rounded.
+*/
+constexpr OutputCurve makeOutputCurve(const float (&gamma)[3]) {
+    OutputCurve curve{};
+    for (int c = 0; c < 3; ++c) {
+        double inv = 1.0 / (double)gamma[c];
+        for (int v = 1; v < 256; ++v) {
+            double x = cxExp(inv * cxLn((double)v / 255.0));
+            curve.level[c][v] = (uint16_t)(OUTPUT_LEVEL_MAX * x + 0.5);
+        }
+    }
+    return curve;
+}
+
+/* ---------------- ACTIVE CURVE ---------------- */
+
+// Tables the output stage uses, initially makeOutputCurve(LED_RESPONSE_GAMMA)
+const OutputCurve &outputCurve();
+
+/*
+    Replace channel `c`'s table with a measured one. Rejected (false)
+    unless it starts at 0 (black stays black), never decreases and stays
+    within OUTPUT_LEVEL_MAX. Call before the first frame is shown.
+*/
+bool loadOutputCurve(int c, const uint16_t level[256]);
+
+/*
+    Curve and master level (Q16, outputMaster()) in place, truncated to
+    the bytes to send at FastLED brightness 255. The output pass when
+    TEMPORAL_DITHER is off. Returns the drive totals of the frame.
+*/
+OutputLoad applyOutputCurve(const OutputCurve &curve, CRGB *leds, uint32_t master);
@@ -0,0 +1,99 @@
+#include "led_output.h"
+
+#include <atomic>
+
+#include "clock.h"
+#include "dither.h"
+#include "gamma.h"
+#include "power.h"
+
+static OutputStrip strips[MAX_LED_STRIPS];
+static int         stripCount = 0;
+static CRGB       *frame = nullptr;   // every controller's buffer, physical order
+
+static TemporalDither dither;
+static PowerLimiter   limiter;
+static OutputPower    power;
+static std::atomic<float> pendingHoldSeconds{0.0f};   // 0 = none
+
+// Written by whichever task shows, read by the stats report
+static std::atomic<uint32_t> stripDoneUs[MAX_LED_STRIPS];
+
+/* ---------------- CONTROLLERS ---------------- */
+
+// FastLED takes the data pin as a template argument: one instance per pin
+template <int S>
+static void addStripController(const OutputStrip &strip, CRGB *leds) {
+    FastLED.addLeds<WS2812B, LED_STRIP_PINS[S], GRB>(leds + strip.first, strip.count);
+}
+
+using AddController = void (*)(const OutputStrip &, CRGB *);
+
+static_assert(MAX_LED_STRIPS == 8, "one addStripController per LED_STRIP_PINS entry");
+static const AddController ADD_CONTROLLER[MAX_LED_STRIPS] = {
+    addStripController<0>, addStripController<1>, addStripController<2>, addStripController<3>,
+    addStripController<4>, addStripController<5>, addStripController<6>, addStripController<7>,
+};
+
+void initLedOutput(CRGB *leds) {
+    const LedLayout &layout = ACTIVE_LAYOUT;
+    uint16_t first = 0;
+    stripCount = layout.stripCount;
+    frame = leds;
+    for (int s = 0; s < stripCount; ++s) {
+        OutputStrip &strip = strips[s];
+        strip.pin    = LED_STRIP_PINS[s];
+        strip.first  = first;
+        strip.count  = layout.strips[s];
+        strip.wireUs = strip.count * LED_WIRE_US_PER_PIXEL + LED_LATCH_US;
+        first += strip.count;
+        ADD_CONTROLLER[s](strip, leds);
+    }
+    // The output pass applies the master level; our dither replaces FastLED's,
+    // which only flickers the lowest bit
+    FastLED.setBrightness(255);
+    if (USE_TEMPORAL_DITHER) FastLED.setDither(DISABLE_DITHER);
+}
+
+int ledStripCount() {
+    return stripCount;
+}
+
+const OutputStrip &ledStrip(int s) {
+    return strips[s];
+}
+
+/* ---------------- TRANSMIT ---------------- */
+
+void ledOutputShow(uint32_t master) {
+    float hold = pendingHoldSeconds.exchange(0.0f, std::memory_order_relaxed);
+    if (hold > 0.0f) limiter.reset(POWER_LIMIT_MA, hold);
+
+    uint32_t level = limiter.limit(master);
+    OutputLoad load = USE_TEMPORAL_DITHER ? dither.apply(outputCurve(), frame, level)
+                                          : applyOutputCurve(outputCurve(), frame, level);
+    limiter.update(load);
+    uint32_t ma = (uint32_t)limiter.lastMa;
+    power.ma.store(ma, std::memory_order_relaxed);
+    if (ma > power.peakMa.load(std::memory_order_relaxed)) power.peakMa.store(ma, std::memory_order_relaxed);
+    if (level < master) power.limited.fetch_add(1, std::memory_order_relaxed);
+    power.gain.store(limiter.gain, std::memory_order_relaxed);
+
+    uint32_t t0 = (uint32_t)getTimeMicros();
+    FastLED.show();
+    for (int s = 0; s < stripCount; ++s) {
+        stripDoneUs[s].store(t0 + strips[s].wireUs, std::memory_order_relaxed);
+    }
+}
+
+uint32_t ledStripDoneUs(int s) {
+    return stripDoneUs[s].load(std::memory_order_relaxed);
+}
+
+const OutputPower &ledOutputPower() {
+    return power;
+}
+
+void ledOutputSetPowerHold(float seconds) {
+    pendingHoldSeconds.store(seconds, std::memory_order_relaxed);
+}
@@ -0,0 +1,79 @@
+/*
+    ================================================================
+                   LED OUTPUT (parallel strips)
+    ================================================================
+
+    The layout (topology.h) splits the physical LEDs into output strips,
+    each on its own data pin from LED_STRIP_PINS. Every strip is a
+    separate FastLED controller whose frame buffer is its slice of
+    leds[]. On the ESP32, FastLED's RMT driver puts each controller on
+    its own RMT channel. show() starts them all and returns when the last
+    one has latched, so a frame costs the longest strip's wire time
+    rather than the sum over strips. Left and right eyes on separate
+    strips are also electrically independent.
+
+    The RMT driver does not report completion per channel, so each
+    strip's transmit completion is stamped from the wire model: show()
+    start + its length · LED_WIRE_US_PER_PIXEL + LED_LATCH_US. The host
+    FastLED shim drives the same channels in parallel on the simulated
+    clock, so the scheduler sees target-like show() times.
+
+    The master level is applied here too, in one pass with the output
+    curve (gamma.h): with USE_TEMPORAL_DITHER the frame is dithered down in
+    place (dither.h), otherwise truncated. It goes out at FastLED
+    brightness 255.
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "config.h"
+#include "topology.h"
+
+struct OutputStrip {
+    uint8_t  pin;
+    uint16_t first;    // physical index of its first LED
+    uint16_t count;
+    uint32_t wireUs;   // shift-out plus latch
+};
+
+/*
+    Register one controller per strip of the active layout, each over its
+    slice of `leds` (NUM_LEDS long, physical order).
+*/
+void initLedOutput(CRGB *leds);
+
+int ledStripCount();
+const OutputStrip &ledStrip(int s);
+
+/*
+    Transmit every strip in parallel at `master` (Q16 output level,
+    outputMaster()). Returns once the
+    longest strip has latched. Dithering consumes the frame: the buffer
+    holds the bytes as sent afterwards.
+*/
+void ledOutputShow(uint32_t master);
+
+// When strip `s` finished its latest transmit, getTimeMicros() clock
+uint32_t ledStripDoneUs(int s);
+
+// Power estimate and limiter, written by whichever task shows
+struct OutputPower {
+    std::atomic<uint32_t> ma{0};          // latest frame, mA
+    std::atomic<uint32_t> peakMa{0};      // highest frame sent
+    std::atomic<uint32_t> gain{1u << 16}; // limiter gain, Q16, unity
+    std::atomic<uint32_t> limited{0};     // frames sent below unity gain
+};
+
+const OutputPower &ledOutputPower();
+
+/*
+    Hold the power limiter's peaks for `seconds`, the running program's
+    CompiledProgram::holdSeconds. Safe from another core: the limiter
+    restarts with it at the next ledOutputShow().
+*/
+void ledOutputSetPowerHold(float seconds);
@@ -4,7 +4,7 @@
     ================================================================
 
     ► Scientific improvements based on 2020-2024 research:
-        • Hardware timer-based phase calculation (ultra-low jitter <1μs)
+        • Hardware timer-based phase calculation (free-running 1μs counter)
         • Optimized sinusoidal modulation (recommended by EEG studies)
         • Enhanced frequency range 4-8 Hz (optimal theta entrainment)
         • Improved phase synchronization algorithms
@@ -26,265 +26,212 @@
 #include <Arduino.h>
 #include <FastLED.h>
 #include <math.h>
-#include <driver/timer.h>
 
-/* ------------------- PIN SETTINGS --------------------- */
-#define LED_PIN       12
-#define PANIC_PIN     14     // connect a momentary button to GND
-#define NUM_LEDS      20
+#include "clock.h"
+#include "config.h"
+#include "frame_pipeline.h"
+#include "frame_stream.h"
+#include "gamma.h"
+#include "led_output.h"
+#include "panic.h"
+#include "power.h"
+#include "presentation.h"
+#include "profiler.h"
+#include "render.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "topology.h"
+#include "trig.h"
 
 CRGB leds[NUM_LEDS];
 
-/* ---------------- USER-TUNABLE PARAMETERS -------------- */
-
-// Target theta-range flicker frequencies (4-8 Hz optimal per research).
-// Studies show 5.5-6.5 Hz range is most effective for theta entrainment.
-constexpr float LEFT_FREQ_HZ    = 5.8f;   // Optimized for left hemisphere
-constexpr float RIGHT_FREQ_HZ   = 6.2f;   // Optimized for right hemisphere
-
-// Frequency range for adaptive tuning (if needed in future)
-constexpr float MIN_FREQ_HZ     = 4.0f;
-constexpr float MAX_FREQ_HZ     = 8.0f;
-
-// Optional micro-modulation for texture (fast shimmer).
-// DISABLED by default for cleaner entrainment spectrum.
-constexpr bool  MICRO_ENABLED   = false;
-constexpr float MICRO_FREQ_HZ   = 45.0f;
-
-// Very slow breathing envelope (0.1–0.2 Hz typical for relaxation)
-constexpr float BREATH_FREQ_HZ  = 0.12f;
-
-// Brightness: optimized for safety and effectiveness (research-based)
-constexpr uint8_t GLOBAL_BRIGHTNESS = 70;  // Reduced from 75 for safety
-
-// Preferred frame interval for smooth animation (higher FPS = smoother)
-constexpr unsigned long FRAME_MS = 10;     // ~100 FPS (improved from 83 FPS)
-
-// Smooth fade-in to prevent abrupt onset (critical for safety)
-constexpr float RAMP_IN_SECONDS = 180.0f;  // 3 minutes (increased for comfort)
-
-// Hard safety limit: after this time the device fades to black
-constexpr float MAX_SESSION_SECONDS = 1800.0f;  // 30 minutes (research-recommended max)
-
-// Switch mandala mode every 30 seconds (prevents adaptation)
-constexpr float MODE_DURATION = 30.0f;
-
-// Reflection/echo effect to enrich visuals (reduced for cleaner signal)
-constexpr int   REFLECTION_OFFSET = 2;  // Reduced from 3
-constexpr float REFLECTION_DECAY  = 0.35f;  // Reduced from 0.45f
-
-// SHARPNESS lowered to avoid excessive high-frequency harmonics
-constexpr float PULSE_SHARPNESS = 2.5f;  // Reduced from 3.0f
-
-// Recommended sinusoidal modulation to reduce harmonics (research-proven)
-constexpr bool  USE_SINUSOIDAL_MODULATION = true;
-
-// Phase synchronization enhancement (for better entrainment)
-constexpr bool  USE_PHASE_ENHANCEMENT = true;
-constexpr float PHASE_SYNC_STRENGTH = 0.15f;
-
-/* ---------------- HARDWARE TIMER SETUP -------------------- */
-
-// Hardware timer for ultra-precise timing (ESP32 has 4 timers)
-hw_timer_t * timer = NULL;
-volatile uint64_t timerMicros = 0;
-portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
-
-void IRAM_ATTR onTimer() {
-    portENTER_CRITICAL_ISR(&timerMux);
-    timerMicros += 100;  // 100 microseconds per tick
-    portEXIT_CRITICAL_ISR(&timerMux);
-}
-
-void initHardwareTimer() {
-    // Use timer 0, 80MHz APB clock, divider 80 = 1MHz (1μs resolution)
-    timer = timerBegin(0, 80, true);
-    timerAttachInterrupt(timer, &onTimer, true);  // true = edge trigger
-    // Set alarm to trigger every 100 microseconds
-    timerAlarmWrite(timer, 100, true);
-    timerAlarmEnable(timer);
-}
-
-/* ---------------- SAFETY UTILITIES -------------------- */
-
-inline uint8_t safeClampInt(int v) {
-    if (v < 0) return 0;
-    if (v > 255) return 255;
-    return (uint8_t)v;
-}
-
-inline float clamp01(float v) {
-    return (v < 0.0f) ? 0.0f : ((v > 1.0f) ? 1.0f : v);
+/* ---------------- TIMING ---------------- */
+FrameScheduler scheduler;
+uint64_t tStartUs = 0;
+uint64_t nextStatsUs = 0;
+
+void printSchedulerStats() {
+    const SchedulerStats &st = scheduler.stats;
+    consolePrintf("Frames: %u, late: %u, dropped: %u, max start latency: %u us, max frame: %u us\n",
+                  (unsigned)st.frames, (unsigned)st.late, (unsigned)st.dropped,
+                  (unsigned)st.maxStartLatencyUs, (unsigned)st.maxFrameUs);
+    consolePrintf("Presentation offset: %u us (show start %u us)\n",
+                  (unsigned)presentationOffsetUs(), (unsigned)showStartLatencyUs());
+    if (USE_DUAL_CORE_PIPELINE) {
+        const OutputStats &out = pipelineOutputStats();
+        consolePrintf("Output: shown %u, overwritten %u, max show %u us, max queue %u us\n",
+                      (unsigned)out.shown.load(), (unsigned)pipelineOverwritten(),
+                      (unsigned)out.maxShowUs.load(), (unsigned)out.maxQueueUs.load());
+    }
+    const OutputPower &pw = ledOutputPower();
+    consolePrintf("Power: %u mA, peak %u mA, limiter gain %.3f, %u frames limited\n",
+                  (unsigned)pw.ma.load(), (unsigned)pw.peakMa.load(),
+                  pw.gain.load() / (float)OUTPUT_MASTER_FULL, (unsigned)pw.limited.load());
+    if (USE_FRAME_STREAM) {
+        const StreamStats &in = streamStats();
+        consolePrintf("Stream: received %u, rejected %u, shown %u, late %u, skipped %u, held %u, "
+                      "underruns %u, max queued %u\n",
+                      (unsigned)in.received, (unsigned)in.rejected, (unsigned)in.shown, (unsigned)in.late,
+                      (unsigned)in.skipped, (unsigned)in.held, (unsigned)in.underruns,
+                      (unsigned)in.maxQueued);
+    }
+    telemetryStats(st, presentationOffsetUs());
 }
 
-inline float clamp(float v, float min, float max) {
-    if (v < min) return min;
-    if (v > max) return max;
-    return v;
-}
+/* ---------------- OUTPUT ---------------- */
 
 /*
-    Ultra-accurate phase computation using hardware timer:
-    Hardware timer provides <1μs jitter, critical for entrainment research.
+    Buffer the next frame is rendered into: the pipeline back buffer when
+    the dual-core pipeline is enabled, otherwise the FastLED array itself.
 */
-inline float getTimeSeconds() {
-    portENTER_CRITICAL(&timerMux);
-    uint64_t micros = timerMicros;
-    portEXIT_CRITICAL(&timerMux);
-    return (float)micros * 0.000001f;
-}
-
-inline float phaseOf(float t, float f) {
-    return fmodf(t * f, 1.0f);   // value in 0..1
+CRGB *frameBuffer() {
+    return USE_DUAL_CORE_PIPELINE ? pipelineBackBuffer().leds : leds;
 }
 
 /*
-    Enhanced phase calculation with synchronization support
+    Send the frame in frameBuffer() to the strip. With the pipeline this
+    only hands the buffer to the output task and returns immediately.
 */
-float getEnhancedPhase(float t, float freq, float syncStrength) {
-    float basePhase = phaseOf(t, freq);
-    if (USE_PHASE_ENHANCEMENT && syncStrength > 0.0f) {
-        // Add subtle phase correction for better synchronization
-        float correction = sinf(TWO_PI * basePhase) * syncStrength;
-        return fmodf(basePhase + correction, 1.0f);
+void presentFrame(const FrameTick &frame, uint32_t master) {
+    if (USE_DUAL_CORE_PIPELINE) {
+        PipelineFrame &back = pipelineBackBuffer();
+        back.tick = frame;
+        back.master = master;
+        pipelinePublish();
+    } else {
+        bool blanked = panicBlankFrame(leds);
+        recordShowStart(frame.idealUs, getTimeMicros());
+        uint32_t c0 = profileStamp();
+        ledOutputShow(master);
+        profileSince(PROF_SHOW, c0);
+        if (blanked) panicFrameDark();
     }
-    return basePhase;
 }
 
-/*
-    Smooth exponential pulse (lower sharpness for reduced harmonics)
-*/
-float expPulse(float phase, float sharpness) {
-    return expf(-phase * sharpness);
+void presentBlack() {
+    FrameTick now = {};
+    now.idealUs = now.startUs = getTimeMicros();
+    fill_solid(frameBuffer(), NUM_LEDS, CRGB::Black);
+    presentFrame(now, 0);
 }
 
 /*
-    Enhanced sinusoidal modulation with phase optimization:
-    Research shows pure sinusoidal modulation is most effective for entrainment.
+    Single-key serial commands. Reports are printed between frames only
+    when asked for, so they never skew the numbers they show.
 */
-float sinMod(float t, float freq) {
-    float phase = t * freq;
-    return 0.5f * (1.0f + sinf(TWO_PI * phase));
-}
-
-/*
-    Improved sinusoidal modulation with smoother transitions
-*/
-float sinModSmooth(float t, float freq) {
-    float phase = t * freq;
-    // Use raised cosine for even smoother transitions
-    float raw = sinf(TWO_PI * phase);
-    return 0.5f * (1.0f + raw);
-}
-
-/* ---------------- MANDALA + GEOMETRY MASKS ---------------- */
-
-float spiralMask(int i, float t, float speed) {
-    float pos = (float)i / (float)NUM_LEDS;
-    float shift = fmodf(t * speed, 1.0f);
-
-    float d = fabs(pos - shift);
-    if (d > 0.5f) d = 1.0f - d;
-
-    float m = 1.0f - d * 2.0f;
-    return clamp01(m + 0.2f);
-}
-
-float radialMask(int i, float t, float freq, int petals = 8) {
-    float pos = (float)i / (float)NUM_LEDS;
-    float angle = pos * petals;
-    float carrier = 0.5f * (sinf(TWO_PI * (t * freq + angle)) + 1.0f);
-    return clamp01(carrier);
-}
-
-float interferenceMask(int i, float t, float fL, float fR) {
-    float pos = (float)i / (float)NUM_LEDS;
-    float A = sinf(TWO_PI * (t * fL + pos));
-    float B = sinf(TWO_PI * (t * fR - pos));
-    float mix = (A + B) * 0.25f + 0.5f;
-    return clamp01(mix);
-}
-
-/* ---------------- COLOR UTILITIES ---------------- */
-
-CRGB mixColor(const CRGB &a, const CRGB &b, float w) {
-    return CRGB(
-        safeClampInt(a.r * (1.0f - w) + b.r * w),
-        safeClampInt(a.g * (1.0f - w) + b.g * w),
-        safeClampInt(a.b * (1.0f - w) + b.b * w)
-    );
+void handleSerialCommand(int c) {
+    switch (c) {
+        case 'p': profileDump(false); break;
+        case 'h': profileDump(true); break;
+        case 'r': profileReset(); consolePrintln("Profile reset"); break;
+        case 's': printSchedulerStats(); break;
+        default: break;
+    }
 }
 
-/*
-    Research-optimized colors for theta entrainment:
-    Warmer tones (orange/amber) for left, cooler (blue) for right
-*/
-CRGB getThetaColor(float intensity, bool isLeft) {
-    if (isLeft) {
-        // Warm orange/amber for left hemisphere
-        return CRGB(
-            safeClampInt(255 * intensity),
-            safeClampInt(120 * intensity),
-            safeClampInt(40 * intensity)
-        );
-    } else {
-        // Cool blue for right hemisphere
-        return CRGB(
-            safeClampInt(40 * intensity),
-            safeClampInt(130 * intensity),
-            safeClampInt(255 * intensity)
-        );
+void printSessionProgram() {
+    const CompiledProgram &prog = activeProgram();
+    consolePrintf("Session program: %s (%u segments, %.0f s, power hold %.1f s)\n",
+                  prog.name, (unsigned)prog.source->count, prog.seconds, prog.holdSeconds);
+    static const char *const SWEEP_NAMES[] = {"hold", "linear", "exp"};
+    float start = 0.0f;
+    for (int i = 0; i < prog.source->count; ++i) {
+        const SessionSegment &s = prog.source->segments[i];
+        consolePrintf("  %6.0f s  L %.2f Hz  R %.2f Hz  %-6s  level %.2f\n",
+                      start, s.leftHz, s.rightHz, SWEEP_NAMES[s.sweep], s.level);
+        start += s.seconds;
     }
 }
 
-/* ---------------- PHYSICAL LED ORDER ---------------- */
-const uint8_t spiralOrder[NUM_LEDS] = {
-    9,10,8,11,7,12,6,13,5,14,4,15,3,16,2,17,1,18,0,19
-};
-
-/* ---------------- TIMING ---------------- */
-unsigned long lastFrameMs = 0;
-float tStart = 0;
-
 /* =========================================================
                       SETUP
    ========================================================= */
 void setup() {
-    Serial.begin(115200);
+    initTelemetry();
+    if (USE_FRAME_STREAM) initFrameStream();
+    Serial.begin(USE_FRAME_STREAM ? STREAM_BAUD : 115200);
     delay(500);
     
-    Serial.println("========================================");
-    Serial.println("ESP32 Theta Entrainment System");
-    Serial.println("Research-Grade Version");
-    Serial.println("========================================");
+    consolePrintln("========================================");
+    consolePrintln("ESP32 Theta Entrainment System");
+    consolePrintln("Research-Grade Version");
+    consolePrintln("========================================");
     
     // Initialize hardware timer for precise timing
     initHardwareTimer();
-    Serial.println("Hardware timer initialized");
+    consolePrintln("Hardware timer initialized");
     
     // Configure panic button
-    pinMode(PANIC_PIN, INPUT_PULLUP);
-    Serial.println("Panic button configured on pin 14");
+    initPanicStop();
+    consolePrintf("Panic button configured on pin %d (edge interrupt)\n", PANIC_PIN);
+
+    // Initialize FastLED: one controller per output strip (led_output.h)
+    initLedOutput(leds);
+    for (int s = 0; s < ledStripCount(); ++s) {
+        const OutputStrip &strip = ledStrip(s);
+        consolePrintf("LED strip %d initialized: %d LEDs on pin %d\n", s, strip.count, strip.pin);
+    }
+    consolePrintf("Parallel output: %u us per frame on the wire (%u us serial)\n",
+                  (unsigned)WIRE_PRESENTATION_US,
+                  (unsigned)(NUM_LEDS * LED_WIRE_US_PER_PIXEL + LED_LATCH_US));
 
-    // Initialize FastLED
-    FastLED.addLeds<WS2812B, LED_PIN, GRB>(leds, NUM_LEDS);
-    FastLED.setBrightness(GLOBAL_BRIGHTNESS);
-    Serial.printf("LED strip initialized: %d LEDs on pin %d\n", NUM_LEDS, LED_PIN);
+    if (USE_POWER_LIMITER) {
+        consolePrintf("Power limit: %u mA (full white %.0f mA)\n", (unsigned)POWER_LIMIT_MA,
+                      fullWhiteCurrentMa());
+    }
 
-    fill_solid(leds, NUM_LEDS, CRGB::Black);
-    FastLED.show();
+    // Geometry table (topology.h), built here rather than on the first frame
+    consolePrintf("LED layout: %s\n", topology().name);
 
-    tStart = getTimeSeconds();
-    lastFrameMs = millis();
+    // All show() calls come from the output task once it is running, so
+    // the strip driver's interrupt is allocated on OUTPUT_CORE
+    if (USE_DUAL_CORE_PIPELINE) {
+        startOutputPipeline(leds);
+        consolePrintf("Output task started on core %d\n", OUTPUT_CORE);
+    }
+    presentBlack();
+
+    // Session timeline (see session_program.h); a bad table never runs
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        const CompiledProgram &prog = activeProgram();
+        consolePrintf("Session program %d rejected: %s (segment %d)\n",
+                      ACTIVE_SESSION_PROGRAM, prog.error, prog.errorSegment);
+        telemetryFlush();
+        haltForever();
+    }
+    printSessionProgram();
+    ledOutputSetPowerHold(activeProgram().holdSeconds);
+    if (USE_FRAME_STREAM) {
+        consolePrintf("Frame stream input: %u baud, %d frame buffers, %u ms pre-roll\n",
+                      (unsigned)STREAM_BAUD, STREAM_RING_FRAMES, (unsigned)(STREAM_PREROLL_US / 1000));
+    }
+
+    tStartUs = getTimeMicros();
+    initOscillators();
+    scheduler.begin(tStartUs, FRAME_PERIOD_US);
+    nextStatsUs = tStartUs + (uint64_t)STATS_REPORT_SECONDS * 1000000ULL;
     
-    Serial.printf("Left frequency: %.2f Hz\n", LEFT_FREQ_HZ);
-    Serial.printf("Right frequency: %.2f Hz\n", RIGHT_FREQ_HZ);
-    Serial.printf("Max session time: %.0f seconds (%.1f minutes)\n", 
+    consolePrintf("Max session time: %.0f seconds (%.1f minutes)\n", 
                   MAX_SESSION_SECONDS, MAX_SESSION_SECONDS / 60.0f);
-    Serial.printf("Ramp-in time: %.0f seconds (%.1f minutes)\n", 
-                  RAMP_IN_SECONDS, RAMP_IN_SECONDS / 60.0f);
-    Serial.println("System ready. Session started.");
-    Serial.println("========================================");
+    if (PRINT_TRIG_REPORT) {
+        TrigReport tr = measureTrigBackend();
+        consolePrintf("Trig backend: %s\n", TRIG_USE_LUT ? "Q15 LUT" : "float reference");
+        consolePrintf("  sin max error %.2e, %u cycles/call (sinf %u)\n",
+                      tr.sinMaxError, (unsigned)tr.sinCyclesActive, (unsigned)tr.sinCyclesRef);
+        consolePrintf("  exp max error %.2e, %u cycles/call (expf %u)\n",
+                      tr.expMaxError, (unsigned)tr.expCyclesActive, (unsigned)tr.expCyclesRef);
+        // Worst case is interference mode: two sines per body LED plus six
+        // per-frame sines (2x sync, 2x modulation, breathe, micro)
+        uint32_t sinPerFrame = 2 * (NUM_LEDS - 4) + 6;
+        consolePrintf("  ~%u trig cycles/frame (float reference %u)\n",
+                      (unsigned)(sinPerFrame * tr.sinCyclesActive),
+                      (unsigned)(sinPerFrame * tr.sinCyclesRef));
+    }
+
+    consolePrintln("System ready. Session started.");
+    consolePrintln("========================================");
+    telemetrySession();
+    telemetryPump();
 }
 
 /* =========================================================
@@ -292,154 +239,82 @@ void setup() {
    ========================================================= */
 void loop() {
 
+    // ----------- FRAME RATE CONTROL ------------
+    // Sleeps until the next exact deadline (no busy polling)
+    FrameTick frame = scheduler.waitForNextFrame();
+    uint32_t frameCycles = profileStamp();
+
     // ----------- HARD PANIC STOP --------------
-    if (digitalRead(PANIC_PIN) == LOW) {
-        Serial.println("!!! PANIC STOP ACTIVATED !!!");
-        fill_solid(leds, NUM_LEDS, CRGB::Black);
-        FastLED.show();
-        while (true) {
-            delay(1000);
-            // Keep checking - allow restart if button released
-            if (digitalRead(PANIC_PIN) == HIGH) {
-                Serial.println("Panic button released. System halted.");
-            }
-        }
+    // The edge interrupt has normally blanked the strip already; polling
+    // only catches a button held down since boot
+    if (digitalRead(PANIC_PIN) == LOW) latchPanicStop();
+    if (panicActive()) {
+        presentBlack();
+        for (int i = 0; i < 100 && !panicDark(); ++i) delay(1);   // output task
+        consolePrintln("!!! PANIC STOP ACTIVATED !!!");
+        if (panicDark()) consolePrintf("Press-to-dark latency: %u us\n", (unsigned)panicLatencyUs());
+        else             consolePrintln("Output not confirmed dark after 100 ms");
+        telemetryEvent(TELEM_EVENT_PANIC, panicDark() ? panicLatencyUs() : 0);
+        telemetryFlush();
+        haltForever();
     }
 
-    // ----------- FRAME RATE CONTROL ------------
-    unsigned long nowMs = millis();
-    if (nowMs - lastFrameMs < FRAME_MS) return;
-    lastFrameMs = nowMs;
-
     // ----------- TIME & SAFETY LIMITS ----------
-    float t = getTimeSeconds() - tStart;
-
-    // Enhanced smooth ramp-in with exponential curve
-    float rampMul = clamp01(t / RAMP_IN_SECONDS);
-    // Apply smooth exponential curve for more natural onset
-    rampMul = rampMul * rampMul * (3.0f - 2.0f * rampMul);  // Smoothstep function
+    // Render for the predicted moment the frame becomes visible, measured
+    // from the ideal deadline so start jitter never reaches phase
+    uint64_t presentUs = frame.idealUs;
+    if (USE_PRESENTATION_COMPENSATION) presentUs += presentationOffsetUs();
+    uint64_t tUs = presentUs - tStartUs;
+    uint32_t c0 = profileStamp();
+    FrameParams fp = computeFrameParams(tUs);
+    profileSince(PROF_PHASES, c0);
 
     // Session expiration → smooth fade out
-    if (t > MAX_SESSION_SECONDS) {
-        float fade = clamp01(1.0f - (t - MAX_SESSION_SECONDS) / 15.0f);  // 15s fade-out
-        if (fade <= 0.01f) {
-            Serial.println("Session timeout reached. Shutting down.");
-            fill_solid(leds, NUM_LEDS, CRGB::Black);
-            FastLED.show();
-            while (true) delay(1000);  // end session forever
-        }
-        // Smooth exponential fade
-        fade = fade * fade;
-        FastLED.setBrightness((uint8_t)(GLOBAL_BRIGHTNESS * fade));
+    if (sessionFinished(fp.t)) {
+        consolePrintln("Session timeout reached. Shutting down.");
+        printSchedulerStats();
+        presentBlack();
+        telemetryEvent(TELEM_EVENT_SESSION_END, (uint32_t)(tUs / 1000));
+        telemetryFlush();
+        haltForever();  // end session forever
     }
 
-    // ----------- MANDALA MODE CYCLING ----------
-    int mandalaMode = ((int)(t / MODE_DURATION)) % 3;
-
-    // ----------- BASE PHASES (with enhancement) ----------
-    float phL = getEnhancedPhase(t, LEFT_FREQ_HZ, PHASE_SYNC_STRENGTH);
-    float phR = getEnhancedPhase(t, RIGHT_FREQ_HZ, PHASE_SYNC_STRENGTH);
-
-    // ----------- SELECTED MODULATION TYPE --------
-    float ampL, ampR;
-
-    if (USE_SINUSOIDAL_MODULATION) {
-        // Use enhanced smooth sinusoidal modulation
-        ampL = sinModSmooth(t, LEFT_FREQ_HZ);
-        ampR = sinModSmooth(t, RIGHT_FREQ_HZ);
+    // ----------- RENDER (float or Q15, see render.h) ----------
+    // In stream mode the frame comes from the host instead (frame_stream.h)
+    c0 = profileStamp();
+    if (!USE_FRAME_STREAM) {
+        renderFrame(fp, frameBuffer());
     } else {
-        ampL = expPulse(phL, PULSE_SHARPNESS);
-        ampR = expPulse(phR, PULSE_SHARPNESS);
+        streamReceive(handleSerialCommand);
+        if (!streamFrame(tUs, frameBuffer())) {
+            consolePrintln("Frame stream ended. Shutting down.");
+            printSchedulerStats();
+            presentBlack();
+            telemetryEvent(TELEM_EVENT_SESSION_END, (uint32_t)(tUs / 1000));
+            telemetryFlush();
+            haltForever();
+        }
     }
+    profileSince(PROF_RENDER, c0);
 
-    // Micro-texture (optional, disabled by default)
-    float micro = MICRO_ENABLED ?
-        0.5f * (sinf(TWO_PI * MICRO_FREQ_HZ * t) + 1.0f) : 1.0f;
-
-    // Breathing envelope (very slow modulation)
-    float breathe = 0.85f + 0.15f * sinf(TWO_PI * BREATH_FREQ_HZ * t);
+    presentFrame(frame, outputMaster(fp.master));
+    uint64_t endUs = getTimeMicros();
+    scheduler.endFrame(frame, endUs);
+    profileSince(PROF_FRAME, frameCycles);
 
-    // Final amplitudes with all modulations
-    float finalL = clamp01(ampL * micro * rampMul * breathe);
-    float finalR = clamp01(ampR * micro * rampMul * breathe);
-
-    // ----------- COLORS (research-optimized) ------------
-    CRGB leftColor    = CRGB(255, 120, 40);   // Warm orange
-    CRGB rightColor   = CRGB(40, 130, 255);   // Cool blue
-    CRGB centerColor  = CRGB(255, 200, 90);   // Warm amber
-
-    // Clear
-    for (int i = 0; i < NUM_LEDS; ++i) leds[i] = CRGB::Black;
-
-    // ----------- LEFT CORE ------------
-    for (int i = 0; i < 3; ++i) {
-        uint8_t idx = spiralOrder[i];
-        float mask = spiralMask(i, t, 0.25f + LEFT_FREQ_HZ * 0.02f);
-        float amp = finalL * mask;
-
-        leds[idx] = CRGB(
-            safeClampInt(leftColor.r * amp),
-            safeClampInt(leftColor.g * amp),
-            safeClampInt(leftColor.b * amp)
-        );
-    }
+    // ----------- TELEMETRY (never blocks) ------------
+    telemetryFrame(frame, fp, tUs, endUs);
+    telemetryPump();
 
-    // ----------- RIGHT CORE ------------
-    for (int i = NUM_LEDS - 3; i < NUM_LEDS; ++i) {
-        uint8_t idx = spiralOrder[i];
-        float mask = spiralMask(i, t, 0.25f + RIGHT_FREQ_HZ * 0.02f);
-        float amp = finalR * mask;
-
-        leds[idx] = CRGB(
-            safeClampInt(rightColor.r * amp),
-            safeClampInt(rightColor.g * amp),
-            safeClampInt(rightColor.b * amp)
-        );
+    // ----------- TIMING REPORT ------------
+    if (frame.idealUs >= nextStatsUs) {
+        printSchedulerStats();
+        nextStatsUs += (uint64_t)STATS_REPORT_SECONDS * 1000000ULL;
     }
 
-    // ----------- CENTER ANCHORS ------------
-    uint8_t c0 = spiralOrder[0];
-    uint8_t c1 = spiralOrder[1];
-    float centerAmp = clamp01((finalL + finalR) * 0.5f);
-
-    leds[c0] = CRGB(
-        safeClampInt(centerColor.r * centerAmp),
-        safeClampInt(centerColor.g * centerAmp),
-        safeClampInt(centerColor.b * centerAmp)
-    );
-    leds[c1] = leds[c0];
-
-    // ----------- MAIN BODY PATTERNS ------------
-    for (int pos = 2; pos < NUM_LEDS - 2; ++pos) {
-        uint8_t idx = spiralOrder[pos];
-
-        float mask = 0.0f;
-        if      (mandalaMode == 0) mask = radialMask(pos, t, (LEFT_FREQ_HZ + RIGHT_FREQ_HZ)*0.5f, 8);
-        else if (mandalaMode == 1) mask = spiralMask(pos, t, 0.3f + 0.02f * ((LEFT_FREQ_HZ + RIGHT_FREQ_HZ)*0.5f));
-        else                       mask = interferenceMask(pos, t, LEFT_FREQ_HZ, RIGHT_FREQ_HZ);
-
-        mask = clamp01(mask);
-
-        float stereoMix = (pos < NUM_LEDS / 2) ? 0.8f : 0.2f;
-        float mixedAmp = clamp01(mask * (stereoMix * finalL + (1.0f - stereoMix) * finalR));
-
-        CRGB blended = mixColor(centerColor, mixColor(leftColor, rightColor, 0.5f), 0.6f);
-
-        int r = blended.r * mixedAmp;
-        int g = blended.g * mixedAmp;
-        int b = blended.b * mixedAmp;
-
-        leds[idx] = CRGB(safeClampInt(r), safeClampInt(g), safeClampInt(b));
-
-        // Reflection echo (reduced for cleaner signal)
-        int echoPos = pos + REFLECTION_OFFSET;
-        if (echoPos < NUM_LEDS) {
-            uint8_t echoIdx = spiralOrder[echoPos];
-            leds[echoIdx].r = qadd8(leds[echoIdx].r, (uint8_t)(r * REFLECTION_DECAY));
-            leds[echoIdx].g = qadd8(leds[echoIdx].g, (uint8_t)(g * REFLECTION_DECAY));
-            leds[echoIdx].b = qadd8(leds[echoIdx].b, (uint8_t)(b * REFLECTION_DECAY));
-        }
+    // ----------- SERIAL COMMANDS ------------
+    // (in stream mode they arrive as STREAM_KEY packets)
+    if (!USE_FRAME_STREAM) {
+        while (Serial.available() > 0) handleSerialCommand(Serial.read());
     }
-
-    FastLED.show();
 }
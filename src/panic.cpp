@@ -0,0 +1,77 @@
+#include "panic.h"
+
+#include <Arduino.h>
+#include <atomic>
+
+#include "clock.h"
+#include "config.h"
+#include "frame_pipeline.h"
+#include "scheduler.h"
+
+#if defined(ARDUINO)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Low 32 bits of getTimeMicros(); differences stay exact across wrap
+static std::atomic<bool>     claimed(false);
+static std::atomic<bool>     active(false);
+static std::atomic<uint32_t> pressUs(0);
+static std::atomic<bool>     dark(false);
+static std::atomic<uint32_t> darkUs(0);
+
+// Called from onPanicEdge(), so it must stay in IRAM with the ISR
+static bool IRAM_ATTR latch() {
+    if (claimed.exchange(true)) return false;   // bounces and repeats
+    pressUs.store((uint32_t)getTimeMicros(), std::memory_order_relaxed);
+    active.store(true, std::memory_order_release);
+    return true;
+}
+
+static void IRAM_ATTR onPanicEdge() {
+    if (!latch()) return;
+    if (USE_DUAL_CORE_PIPELINE) pipelineWakeFromIsr();
+    wakeSchedulerFromIsr();
+}
+
+void initPanicStop() {
+    pinMode(PANIC_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(PANIC_PIN), onPanicEdge, FALLING);
+}
+
+void latchPanicStop() {
+    latch();
+}
+
+bool panicActive() {
+    return active.load(std::memory_order_acquire);
+}
+
+bool panicBlankFrame(CRGB *leds) {
+    if (!panicActive()) return false;
+    fill_solid(leds, NUM_LEDS, CRGB::Black);
+    return true;
+}
+
+void panicFrameDark() {
+    if (dark.load(std::memory_order_relaxed)) return;
+    darkUs.store((uint32_t)getTimeMicros() + LED_LATCH_US, std::memory_order_relaxed);
+    dark.store(true, std::memory_order_release);
+}
+
+bool panicDark() {
+    return dark.load(std::memory_order_acquire);
+}
+
+uint32_t panicLatencyUs() {
+    if (!panicDark() || !panicActive()) return 0;
+    return darkUs.load(std::memory_order_relaxed) - pressUs.load(std::memory_order_relaxed);
+}
+
+void haltForever() {
+#if defined(ARDUINO)
+    for (;;) vTaskSuspend(nullptr);
+#else
+    for (;;) delay(1000);   // the host driver ends the run from delay()
+#endif
+}
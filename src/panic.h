@@ -0,0 +1,61 @@
+/*
+    ================================================================
+                      PANIC STOP (edge interrupt)
+    ================================================================
+
+    A falling edge on PANIC_PIN latches the panic stop from an ISR, so
+    reaction time no longer depends on where loop() happens to be:
+
+      ISR               latch, timestamp the press, wake whoever owns
+                        FastLED.show() (output task or render task)
+      show() owner      from then on every frame it sends is blanked;
+                        the first dark frame is timestamped after its
+                        latch pulse
+
+    A transmission already on the wire finishes (WS2812B has no abort),
+    so worst-case press-to-dark is about two strip transmissions plus a
+    task wake-up, independent of render time. loop() still polls the pin
+    to catch a button that is held down since boot (no edge).
+
+    Host builds drive the pin with hostSetPinLevel() or, at an exact
+    simulated time, hostSchedulePinLevel().
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+
+/*
+    Configure PANIC_PIN with pull-up and attach the edge interrupt.
+*/
+void initPanicStop();
+
+/*
+    Latch the panic stop from task context (the polled fallback).
+*/
+void latchPanicStop();
+
+// Latched; never clears until reset
+bool panicActive();
+
+/*
+    Call with the buffer about to go to FastLED.show(). Once the panic
+    stop has latched it blanks the buffer and returns true; call
+    panicFrameDark() after that show() returns.
+*/
+bool panicBlankFrame(CRGB *leds);
+void panicFrameDark();
+
+// The first blanked frame has latched
+bool panicDark();
+
+/*
+    Press (edge) to dark (latch of the first blanked frame), μs.
+*/
+uint32_t panicLatencyUs();
+
+/*
+    Park the calling task for good (end of session or panic).
+*/
+void haltForever();
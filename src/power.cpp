@@ -0,0 +1,77 @@
+#include "power.h"
+
+#include <math.h>
+
+constexpr uint32_t RELEASE_STEP = (uint32_t)(OUTPUT_MASTER_FULL * (float)FRAME_PERIOD_US /
+                                             (POWER_RELEASE_SECONDS * 1e6f));
+
+static_assert(RELEASE_STEP > 0, "power limiter timing");
+
+// Current above idle, mA
+static float driveCurrentMa(const OutputLoad &load) {
+    constexpr float SCALE = 1.0f / OUTPUT_LEVEL_MAX;
+    return (LED_CHANNEL_MA[0] * (float)load.drive[0] + LED_CHANNEL_MA[1] * (float)load.drive[1] +
+            LED_CHANNEL_MA[2] * (float)load.drive[2]) * SCALE;
+}
+
+float estimateCurrentMa(const OutputLoad &load) {
+    return LED_IDLE_MA * NUM_LEDS + driveCurrentMa(load);
+}
+
+float fullWhiteCurrentMa() {
+    return NUM_LEDS * (LED_IDLE_MA + LED_CHANNEL_MA[0] + LED_CHANNEL_MA[1] + LED_CHANNEL_MA[2]);
+}
+
+void PowerLimiter::reset(uint32_t budget, float holdSeconds) {
+    // Whole frames, at least one; a near-unison beat can run for hours
+    double frames = ceil((double)holdSeconds * 1e6 / FRAME_PERIOD_US);
+    holdFrames = (frames < 1.0) ? 1 : (frames > (double)UINT32_MAX) ? UINT32_MAX : (uint32_t)frames;
+    budgetMa = budget;
+    gain = heldGain = OUTPUT_MASTER_FULL;
+    peakMa[0] = peakMa[1] = 0.0f;
+    prevMa = 0.0f;
+    blockFrames = 0;
+    lastMa = LED_IDLE_MA * NUM_LEDS;
+}
+
+// Gain that brings a `peakMa` unlimited drive current to the budget less headroom
+uint32_t PowerLimiter::fitGain(float peakMa) const {
+    float avail = (float)budgetMa * (1.0f - POWER_HEADROOM) - LED_IDLE_MA * NUM_LEDS;
+    if (avail <= 0.0f)        return 0;
+    if (peakMa <= avail)      return OUTPUT_MASTER_FULL;
+    return (uint32_t)(avail / peakMa * (float)OUTPUT_MASTER_FULL);
+}
+
+void PowerLimiter::update(const OutputLoad &load) {
+    float drive = driveCurrentMa(load);
+    lastMa = LED_IDLE_MA * NUM_LEDS + drive;
+    if (budgetMa == 0) return;
+
+    // What the frame would have drawn at unity gain; unknown at gain 0
+    float predicted = 0.0f;
+    if (gain > 0) {
+        float unlimited = drive * ((float)OUTPUT_MASTER_FULL / (float)gain);
+        // Climbing past every held peak: the next frame will likely be higher
+        // still, by up to the last step (but no more than the excess). Only
+        // the measured peak is held; the guess only lowers the next gain.
+        float excess = unlimited - fmaxf(peakMa[0], peakMa[1]);
+        predicted = unlimited;
+        if (excess > 0.0f) predicted += fminf(excess, fmaxf(unlimited - prevMa, 0.0f));
+        if (unlimited > peakMa[1]) peakMa[1] = unlimited;
+        prevMa = unlimited;
+    }
+    if (++blockFrames >= holdFrames) {
+        peakMa[0] = peakMa[1];
+        peakMa[1] = 0.0f;
+        blockFrames = 0;
+    }
+
+    // Attack at once, release slowly
+    uint32_t target = fitGain(fmaxf(peakMa[0], peakMa[1]));
+    if (target < heldGain)                     heldGain = target;
+    else if (target - heldGain > RELEASE_STEP) heldGain += RELEASE_STEP;
+    else                                       heldGain = target;
+
+    uint32_t ahead = fitGain(predicted);
+    gain = (ahead < heldGain) ? ahead : heldGain;
+}
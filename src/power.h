@@ -0,0 +1,82 @@
+/*
+    ================================================================
+               POWER BUDGET (current estimate and limiter)
+    ================================================================
+
+    A WS2812B draws a fixed idle current plus, per channel, a current
+    proportional to its PWM duty. The output pass (gamma.h, dither.h)
+    already computes every channel's drive level, so it sums them on
+    the way (OutputLoad) and the frame's current is one multiply-add per
+    channel afterwards:
+
+        mA = NUM_LEDS · LED_IDLE_MA + Σc LED_CHANNEL_MA[c] · drive[c] / OUTPUT_LEVEL_MAX
+
+    No second pass over the frame, and no per-pixel work beyond three
+    adds.
+
+    Clipping each frame to POWER_LIMIT_MA would flatten the flicker
+    peaks and add harmonics. The limiter instead scales the master
+    level by one gain and keeps it constant across flicker cycles, so
+    the waveform keeps its shape and only its amplitude changes. It
+    predicts the next cycles' peak as the highest unlimited current seen
+    over the last hold time to twice that. The hold is the period of the
+    running program's slowest modulation, the breathing envelope or its
+    slowest held L/R beat (CompiledProgram::holdSeconds, passed to
+    reset()), so the window always spans a whole cycle of every
+    modulation and the gain stays put through it. It aims
+    POWER_HEADROOM below the budget for peaks that grow from cycle to
+    cycle. The gain is cut to fit a new peak at once, and released
+    towards unity over POWER_RELEASE_SECONDS once the peak has been gone
+    for a whole window. Only level changes slower than that, such as the
+    ramp-in and the program's level curves, are followed.
+
+    The gain applies from the frame after the one it was computed from.
+    While the load climbs past every held peak, the next frame is
+    extrapolated from the last step, so a steady rise stays within the
+    budget and only a sudden jump overshoots, for one frame (10 ms). The
+    guess only lowers that one frame's gain: it is not held and not
+    released from slowly, so a jump that overshoots it costs nothing
+    after the frame.
+    tools/power_check drives synthetic worst-case frames through the
+    real output pass.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+#include "gamma.h"
+
+// Supply current of a frame the output pass drove with `load`, mA
+float estimateCurrentMa(const OutputLoad &load);
+
+// All LEDs fully white at master level 1, mA
+float fullWhiteCurrentMa();
+
+struct PowerLimiter {
+    uint32_t budgetMa;    // 0 = no limit
+    uint32_t gain;        // Q16 on the master level, OUTPUT_MASTER_FULL = unity
+    uint32_t heldGain;    // from the held peaks alone, before the one-frame prediction
+    float    peakMa[2];   // highest unlimited drive current, previous and current block
+    float    prevMa;      // unlimited drive current of the previous frame
+    uint32_t blockFrames; // frames into the current block
+    float    lastMa;      // estimate of the latest frame as sent
+    uint32_t holdFrames;  // block length: the peak is held one to two blocks
+
+    // The fixed protocol's hold until reset() with the program's
+    PowerLimiter() { reset(POWER_LIMIT_MA, slowestModulationSeconds(LEFT_FREQ_HZ, RIGHT_FREQ_HZ)); }
+
+    void reset(uint32_t budget, float holdSeconds);
+
+    // Master level (Q16) for the next output pass
+    uint32_t limit(uint32_t master) const {
+        return (uint32_t)(((uint64_t)master * gain) >> 16);
+    }
+
+    // Account the frame the pass just drove at limit(master)
+    void update(const OutputLoad &load);
+
+private:
+    uint32_t fitGain(float peakMa) const;
+};
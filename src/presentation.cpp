@@ -0,0 +1,25 @@
+#include "presentation.h"
+
+#include <atomic>
+
+// EMA of show-start latency in 1/16 μs units; 0 until the first sample
+static std::atomic<uint32_t> latencyQ4{0};
+
+void recordShowStart(uint64_t idealUs, uint64_t showStartUs) {
+    uint32_t sampleQ4 = (showStartUs > idealUs) ? (uint32_t)(showStartUs - idealUs) << 4 : 0;
+    uint32_t ema = latencyQ4.load(std::memory_order_relaxed);
+    if (ema == 0) {
+        ema = sampleQ4;                                  // seed with the first frame
+    } else {
+        ema = ema + (int32_t)(sampleQ4 - ema) / 8;
+    }
+    latencyQ4.store(ema, std::memory_order_relaxed);
+}
+
+uint32_t showStartLatencyUs() {
+    return latencyQ4.load(std::memory_order_relaxed) >> 4;
+}
+
+uint32_t presentationOffsetUs() {
+    return showStartLatencyUs() + WIRE_PRESENTATION_US;
+}
@@ -0,0 +1,52 @@
+/*
+    ================================================================
+                 PRESENTATION-TIME LATENCY MODEL
+    ================================================================
+
+    Photons leave the LEDs well after a frame's deadline: render time,
+    the handoff to the output task, shifting the pixels down the wire
+    and the latch pulse all add up to hundreds of μs. The engine renders
+    each frame for the predicted moment it becomes visible:
+
+        present = ideal + showStartLatency + longest strip · LED_WIRE_US_PER_PIXEL
+                        + LED_LATCH_US
+
+    Strips transmit in parallel (led_output.h), so only the longest one
+    counts.
+
+    showStartLatency (ideal deadline -> FastLED.show() start) is measured
+    every frame and smoothed with a 1/8 EMA, so each frame is rendered
+    with the latency observed on the frames before it.
+
+    WS2812B pixels buffer their 24 bits and all update together on the
+    reset/latch pulse, so one offset per frame is exact for every LED
+    index; there is no per-LED skew to correct. A shorter strip latches
+    early by its length difference (the built-in layouts split evenly).
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+#include "topology.h"
+
+// Fixed part of the offset: wire time for the longest strip plus the latch
+constexpr uint32_t WIRE_PRESENTATION_US =
+    (uint32_t)longestStrip(ACTIVE_LAYOUT) * LED_WIRE_US_PER_PIXEL + LED_LATCH_US;
+
+/*
+    Record when show() actually started for a frame due at `idealUs`.
+    Safe to call from the output task while the render task predicts.
+*/
+void recordShowStart(uint64_t idealUs, uint64_t showStartUs);
+
+/*
+    Smoothed ideal -> show() start latency, μs.
+*/
+uint32_t showStartLatencyUs();
+
+/*
+    Predicted ideal -> visible offset for the next frame, μs.
+*/
+uint32_t presentationOffsetUs();
@@ -0,0 +1,65 @@
+#include "profiler.h"
+
+#include "telemetry.h"
+
+static CycleHistogram histograms[PROF_STAGE_COUNT];
+
+static const char *const STAGE_NAMES[PROF_STAGE_COUNT] = {
+    "phases", "body", "echo", "render", "show", "frame"
+};
+
+uint32_t CycleHistogram::percentile(uint32_t permille) const {
+    uint32_t total = count.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+    uint64_t rank = ((uint64_t)total * permille + 999) / 1000;
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; ++b) {
+        seen += bins[b].load(std::memory_order_relaxed);
+        if (seen >= rank) return (b + 1 < BUCKETS) ? bucketFloor(b + 1) - 1 : UINT32_MAX;
+    }
+    return maxCycles.load(std::memory_order_relaxed);
+}
+
+void CycleHistogram::reset() {
+    for (std::atomic<uint32_t> &bin : bins) bin.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    maxCycles.store(0, std::memory_order_relaxed);
+}
+
+void profileRecordCycles(ProfileStage stage, uint32_t cycles) {
+    histograms[stage].record(cycles);
+}
+
+void profileDump(bool buckets) {
+    if (!USE_HOT_PATH_PROFILER) {
+        consolePrintln("Profiler disabled (USE_HOT_PATH_PROFILER)");
+        return;
+    }
+    float usPerCycle = 1e6f / (float)cycleCounterHz();
+
+    consolePrintf("Profile (%.1f MHz cycle counter)\n", (float)cycleCounterHz() * 1e-6f);
+    consolePrintf("%-8s %9s %9s %9s %9s %9s\n", "stage", "count", "p50 us", "p90 us", "p99 us", "max us");
+    for (int s = 0; s < PROF_STAGE_COUNT; ++s) {
+        const CycleHistogram &h = histograms[s];
+        consolePrintf("%-8s %9u %9.1f %9.1f %9.1f %9.1f\n", STAGE_NAMES[s],
+                      (unsigned)h.count.load(std::memory_order_relaxed),
+                      h.percentile(500) * usPerCycle, h.percentile(900) * usPerCycle,
+                      h.percentile(990) * usPerCycle,
+                      h.maxCycles.load(std::memory_order_relaxed) * usPerCycle);
+    }
+    if (!buckets) return;
+
+    // "<bucket floor in cycles>:<samples>" for every non-empty bucket
+    for (int s = 0; s < PROF_STAGE_COUNT; ++s) {
+        consolePrintf("%s:", STAGE_NAMES[s]);
+        for (int b = 0; b < CycleHistogram::BUCKETS; ++b) {
+            uint32_t n = histograms[s].bins[b].load(std::memory_order_relaxed);
+            if (n != 0) consolePrintf(" %u:%u", (unsigned)CycleHistogram::bucketFloor(b), (unsigned)n);
+        }
+        consolePrintln();
+    }
+}
+
+void profileReset() {
+    for (CycleHistogram &h : histograms) h.reset();
+}
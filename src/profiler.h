@@ -0,0 +1,107 @@
+/*
+    ================================================================
+                    HOT-PATH CYCLE PROFILER
+    ================================================================
+
+    Cycle counts (cycles.h: CCOUNT on target, TSC on host) for each
+    stage of a frame, recorded into fixed-size log-linear histograms:
+
+      phases   computeFrameParams(): DDS advance + per-frame scalars
+      body     main body loop: mandala masks, stereo mix and colour
+               for every body LED, timed once per pass (stamps
+               inside the loop would cost more than a mask)
+      echo     edge core + reflection echo
+      render   the whole renderFrame()
+      show     FastLED.show() (on the output core with the pipeline)
+      frame    deadline wake-up -> endFrame()
+
+    Recording is a couple of relaxed atomic adds: no locks, no printing,
+    safe from either core. Each stage has a single writer, and a dump
+    can read while frames keep recording. Histograms are printed only on
+    request (serial command, see main.cpp), so the report never disturbs
+    the timing it measures.
+
+    Buckets: 4 per power of two (≤ 25 % wide) over the full 32-bit range.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#include "config.h"
+#include "cycles.h"
+
+enum ProfileStage {
+    PROF_PHASES,
+    PROF_BODY,
+    PROF_ECHO,
+    PROF_RENDER,
+    PROF_SHOW,
+    PROF_FRAME,
+    PROF_STAGE_COUNT
+};
+
+struct CycleHistogram {
+    static constexpr int SUB_BITS = 2;
+    static constexpr int BUCKETS  = (32 - SUB_BITS + 1) << SUB_BITS;
+
+    std::atomic<uint32_t> bins[BUCKETS];
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> maxCycles;
+
+    static int bucketOf(uint32_t cycles) {
+        if (cycles < (1u << SUB_BITS)) return (int)cycles;
+        int msb = 31 - __builtin_clz(cycles);
+        int sub = (int)(cycles >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+        return ((msb - SUB_BITS + 1) << SUB_BITS) | sub;
+    }
+
+    // Smallest cycle count that lands in `bucket`
+    static uint32_t bucketFloor(int bucket) {
+        if (bucket < (1 << SUB_BITS)) return (uint32_t)bucket;
+        int msb = (bucket >> SUB_BITS) + SUB_BITS - 1;
+        uint32_t sub = (uint32_t)(bucket & ((1 << SUB_BITS) - 1));
+        return ((1u << SUB_BITS) | sub) << (msb - SUB_BITS);
+    }
+
+    void record(uint32_t cycles) {
+        bins[bucketOf(cycles)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        uint32_t cur = maxCycles.load(std::memory_order_relaxed);
+        while (cycles > cur && !maxCycles.compare_exchange_weak(cur, cycles, std::memory_order_relaxed)) {}
+    }
+
+    /*
+        Upper edge of the bucket holding the `permille`-th sample.
+    */
+    uint32_t percentile(uint32_t permille) const;
+
+    void reset();
+};
+
+/*
+    Cycle counter reading, or 0 when the profiler is compiled out.
+*/
+inline uint32_t profileStamp() {
+    return USE_HOT_PATH_PROFILER ? readCycleCounter() : 0;
+}
+
+void profileRecordCycles(ProfileStage stage, uint32_t cycles);
+
+inline void profileRecord(ProfileStage stage, uint32_t cycles) {
+    if (USE_HOT_PATH_PROFILER) profileRecordCycles(stage, cycles);
+}
+
+// Record the cycles since `startStamp` (a profileStamp() reading)
+inline void profileSince(ProfileStage stage, uint32_t startStamp) {
+    if (USE_HOT_PATH_PROFILER) profileRecordCycles(stage, readCycleCounter() - startStamp);
+}
+
+/*
+    Print per-stage count, p50/p90/p99/max in μs over Serial; with
+    `buckets`, every non-empty bucket as well.
+*/
+void profileDump(bool buckets);
+
+void profileReset();
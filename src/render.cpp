@@ -0,0 +1,324 @@
+#include "render.h"
+
+#include <math.h>
+
+#include "dds.h"
+#include "profiler.h"
+#include "topology.h"
+#include "trig.h"
+
+/* ---------------- DDS OSCILLATORS -------------------- */
+
+/*
+    Phases are advanced from the microsecond clock, so they never lose
+    precision as the session gets longer (float t * f drifts by ~60 μs
+    after 1000 s).
+*/
+static OscillatorBank oscillators;
+
+void initOscillators() {
+    oscillators.init(activeProgram());
+}
+
+/*
+    Enhanced phase calculation with synchronization support
+*/
+float getEnhancedPhase(float basePhase, float syncStrength) {
+    if (USE_PHASE_ENHANCEMENT && syncStrength > 0.0f) {
+        // Add subtle phase correction for better synchronization
+        float correction = sinTurns(basePhase) * syncStrength;
+        return wrapTurns(basePhase + correction);
+    }
+    return basePhase;
+}
+
+/*
+    Smooth exponential pulse (lower sharpness for reduced harmonics)
+*/
+float expPulse(float phase, float sharpness) {
+    return expNeg(phase * sharpness);
+}
+
+/*
+    Enhanced sinusoidal modulation with phase optimization:
+    Research shows pure sinusoidal modulation is most effective for entrainment.
+*/
+float sinMod(float phase) {
+    return 0.5f * (1.0f + sinTurns(phase));
+}
+
+/*
+    Improved sinusoidal modulation with smoother transitions
+*/
+float sinModSmooth(float phase) {
+    // Use raised cosine for even smoother transitions
+    float raw = sinTurns(phase);
+    return 0.5f * (1.0f + raw);
+}
+
+/* ---------------- PER-FRAME SCALARS ---------------- */
+
+FrameParams computeFrameParams(OscillatorBank &bank, uint64_t sessionUs) {
+    FrameParams fp;
+
+    fp.t = (float)sessionUs * 0.000001f;   // envelopes only; phases come from DDS
+    bank.advanceTo(sessionUs);
+    const Oscillator *osc = bank.osc;
+    const ProgramRecord &seg = bank.segment();
+
+    // Program level: ramp-in, brightness steps and fades (session_program.h)
+    fp.rampMul = programLevel(seg, fp.t);
+
+    // ----------- MANDALA MODE (fixed or cycling) ----------
+    fp.mandalaMode = programMandalaMode(seg, fp.t);
+
+    // ----------- BASE PHASES (with enhancement) ----------
+    fp.phaseLeft        = osc[OSC_LEFT].phaseQ32();
+    fp.phaseRight       = osc[OSC_RIGHT].phaseQ32();
+    fp.phaseCarrier     = osc[OSC_CARRIER].phaseQ32();
+    fp.phaseSpiralLeft  = osc[OSC_SPIRAL_LEFT].phaseQ32();
+    fp.phaseSpiralRight = osc[OSC_SPIRAL_RIGHT].phaseQ32();
+    fp.phaseSpiralBody  = osc[OSC_SPIRAL_BODY].phaseQ32();
+
+    float baseL = osc[OSC_LEFT].phase01();
+    float baseR = osc[OSC_RIGHT].phase01();
+
+    // ----------- SELECTED MODULATION TYPE --------
+    float ampL, ampR;
+
+    if (seg.modulation == MOD_SINE) {
+        // Use enhanced smooth sinusoidal modulation
+        ampL = sinModSmooth(baseL);
+        ampR = sinModSmooth(baseR);
+    } else {
+        float phL = getEnhancedPhase(baseL, PHASE_SYNC_STRENGTH);
+        float phR = getEnhancedPhase(baseR, PHASE_SYNC_STRENGTH);
+        ampL = expPulse(phL, PULSE_SHARPNESS);
+        ampR = expPulse(phR, PULSE_SHARPNESS);
+    }
+
+    // Micro-texture (optional, disabled by default)
+    fp.micro = MICRO_ENABLED ?
+        0.5f * (sinTurns(osc[OSC_MICRO].phase01()) + 1.0f) : 1.0f;
+
+    // Master level: brightness and the end fade, applied at output
+    fp.master = sessionLevel(fp.t);
+
+    // Breathing envelope (very slow modulation)
+    fp.breathe = 0.85f + 0.15f * sinTurns(osc[OSC_BREATH].phase01());
+
+    // Final amplitudes with all modulations
+    fp.finalL = clamp01(ampL * fp.micro * fp.rampMul * fp.breathe);
+    fp.finalR = clamp01(ampR * fp.micro * fp.rampMul * fp.breathe);
+
+    return fp;
+}
+
+FrameParams computeFrameParams(uint64_t sessionUs) {
+    return computeFrameParams(oscillators, sessionUs);
+}
+
+/* ---------------- SESSION ENVELOPE ---------------- */
+
+float sessionEndSeconds() {
+    float end = activeProgram().seconds;
+    return (end < MAX_SESSION_SECONDS) ? end : MAX_SESSION_SECONDS;
+}
+
+// Remaining fade level (1 → 0) after the end of the session
+static float fadeLevel(float t) {
+    return clamp01(1.0f - (t - sessionEndSeconds()) / FADE_OUT_SECONDS);
+}
+
+float sessionLevel(float t) {
+    constexpr float FULL = (GLOBAL_BRIGHTNESS + 1) / 256.0f;
+    if (t <= sessionEndSeconds()) return FULL;
+    // Smooth quadratic fade
+    float fade = fadeLevel(t);
+    return FULL * fade * fade;
+}
+
+bool sessionFinished(float t) {
+    return t > sessionEndSeconds() && fadeLevel(t) <= 0.01f;
+}
+
+/* ---------------- MANDALA + GEOMETRY MASKS ---------------- */
+
+float spiralMask(float pos, float shift) {
+    float d = fabs(pos - shift);
+    if (d > 0.5f) d = 1.0f - d;
+
+    float m = 1.0f - d * 2.0f;
+    return clamp01(m + 0.2f);
+}
+
+float radialMask(float petal, float phase, int petals) {
+    float angle = petal * petals;
+    float carrier = 0.5f * (sinTurns(phase + angle) + 1.0f);
+    return clamp01(carrier);
+}
+
+float interferenceMask(float pos, float phaseL, float phaseR) {
+    float A = sinTurns(phaseL + pos);
+    float B = sinTurns(phaseR - pos);
+    float mix = (A + B) * 0.25f + 0.5f;
+    return clamp01(mix);
+}
+
+/* ---------------- COLOR UTILITIES ---------------- */
+
+CRGB mixColor(const CRGB &a, const CRGB &b, float w) {
+    return CRGB(
+        safeClampInt(a.r * (1.0f - w) + b.r * w),
+        safeClampInt(a.g * (1.0f - w) + b.g * w),
+        safeClampInt(a.b * (1.0f - w) + b.b * w)
+    );
+}
+
+/*
+    Research-optimized colors for theta entrainment:
+    Warmer tones (orange/amber) for left, cooler (blue) for right
+*/
+CRGB getThetaColor(float intensity, bool isLeft) {
+    if (isLeft) {
+        // Warm orange/amber for left hemisphere
+        return CRGB(
+            safeClampInt(255 * intensity),
+            safeClampInt(120 * intensity),
+            safeClampInt(40 * intensity)
+        );
+    } else {
+        // Cool blue for right hemisphere
+        return CRGB(
+            safeClampInt(40 * intensity),
+            safeClampInt(130 * intensity),
+            safeClampInt(255 * intensity)
+        );
+    }
+}
+
+/* ---------------- MASK POLICIES ---------------- */
+
+/*
+    One type per mandala mode. The constructor does the per-frame work
+    (phase conversions) and picks its column of the topology table,
+    operator() is the per-LED mask at spiral rank r. The body loop is a
+    template over these, so the mode switch happens once per frame.
+*/
+struct RadialMaskPolicy {
+    const float *petal;
+    float phase;
+    RadialMaskPolicy(const FrameParams &fp, const Topology &t)
+        : petal(t.petal), phase(phase01(fp.phaseCarrier)) {}
+    float operator()(int r) const { return radialMask(petal[r], phase, 8); }
+};
+
+struct SpiralMaskPolicy {
+    const float *spiral;
+    float shift;
+    SpiralMaskPolicy(const FrameParams &fp, const Topology &t)
+        : spiral(t.spiral), shift(phase01(fp.phaseSpiralBody)) {}
+    float operator()(int r) const { return spiralMask(spiral[r], shift); }
+};
+
+struct InterferenceMaskPolicy {
+    const float *spiral;
+    float baseL, baseR;
+    InterferenceMaskPolicy(const FrameParams &fp, const Topology &t)
+        : spiral(t.spiral), baseL(phase01(fp.phaseLeft)), baseR(phase01(fp.phaseRight)) {}
+    float operator()(int r) const { return interferenceMask(spiral[r], baseL, baseR); }
+};
+
+// Per-frame values shared by every body LED
+struct BodyInvariants {
+    CRGB  blended;   // body colour
+    float amp[2];    // stereo-weighted amplitude, by eye
+};
+
+template <typename Mask>
+static void renderBody(const FrameParams &fp, const BodyInvariants &inv, const Topology &t, CRGB *leds) {
+    const Mask maskAt(fp, t);
+
+    uint32_t c0 = profileStamp();
+    for (int r = ANCHOR_LEDS; r < NUM_LEDS - EDGE_LEDS; ++r) {
+        float mask = clamp01(maskAt(r));
+        float mixedAmp = clamp01(mask * inv.amp[t.eye[r]]);
+
+        int red   = inv.blended.r * mixedAmp;
+        int green = inv.blended.g * mixedAmp;
+        int blue  = inv.blended.b * mixedAmp;
+
+        leds[t.led[r]] = CRGB(safeClampInt(red), safeClampInt(green), safeClampInt(blue));
+    }
+    profileRecord(PROF_BODY, profileStamp() - c0);
+}
+
+using BodyKernel = void (*)(const FrameParams &, const BodyInvariants &, const Topology &, CRGB *);
+
+// Indexed by FrameParams::mandalaMode
+static const BodyKernel BODY_KERNELS[3] = {
+    renderBody<RadialMaskPolicy>,
+    renderBody<SpiralMaskPolicy>,
+    renderBody<InterferenceMaskPolicy>,
+};
+
+/* ---------------- FLOAT RENDER PATH ---------------- */
+
+void renderFrameFloat(const FrameParams &fp, CRGB *leds) {
+    const Topology &t = topology();
+    const float finalL = fp.finalL;
+    const float finalR = fp.finalR;
+
+    // ----------- COLORS (research-optimized) ------------
+    const CRGB leftColor   = LEFT_COLOR;
+    const CRGB rightColor  = RIGHT_COLOR;
+    const CRGB centerColor = CENTER_COLOR;
+
+    // Anchors, body and edge cover every LED: no clear needed
+
+    // ----------- CENTER ANCHORS ------------
+    float centerAmp = clamp01((finalL + finalR) * 0.5f);
+    const CRGB center(
+        safeClampInt(centerColor.r * centerAmp),
+        safeClampInt(centerColor.g * centerAmp),
+        safeClampInt(centerColor.b * centerAmp)
+    );
+    for (int r = 0; r < ANCHOR_LEDS; ++r) leds[t.led[r]] = center;
+
+    // ----------- MAIN BODY PATTERNS ------------
+    const float nearMix = 0.8f, farMix = 0.2f;
+    BodyInvariants inv;
+    inv.blended = mixColor(centerColor, mixColor(leftColor, rightColor, 0.5f), 0.6f);
+    inv.amp[0]  = nearMix * finalL + (1.0f - nearMix) * finalR;
+    inv.amp[1]  = farMix * finalL + (1.0f - farMix) * finalR;
+    BODY_KERNELS[fp.mandalaMode](fp, inv, t, leds);
+
+    renderEchoFloat(fp, leds);
+}
+
+/* ---------------- EDGE CORE + REFLECTION ECHO ---------------- */
+
+void renderEchoFloat(const FrameParams &fp, CRGB *leds) {
+    const Topology &t = topology();
+    const CRGB rightColor = RIGHT_COLOR;
+    const float finalR = fp.finalR;
+
+    uint32_t c0 = profileStamp();
+    const float spiralRight = phase01(fp.phaseSpiralRight);
+    for (int r = NUM_LEDS - EDGE_LEDS; r < NUM_LEDS; ++r) {
+        float amp = finalR * spiralMask(t.spiral[r], spiralRight);
+        CRGB px(
+            safeClampInt(rightColor.r * amp),
+            safeClampInt(rightColor.g * amp),
+            safeClampInt(rightColor.b * amp)
+        );
+        if (t.echo[r] >= 0) {
+            const CRGB &src = leds[t.led[t.echo[r]]];
+            px.r = qadd8(px.r, (uint8_t)(src.r * REFLECTION_DECAY));
+            px.g = qadd8(px.g, (uint8_t)(src.g * REFLECTION_DECAY));
+            px.b = qadd8(px.b, (uint8_t)(src.b * REFLECTION_DECAY));
+        }
+        leds[t.led[r]] = px;
+    }
+    profileRecord(PROF_ECHO, profileStamp() - c0);
+}
@@ -0,0 +1,161 @@
+/*
+    ================================================================
+                         FRAME RENDER ENGINE
+    ================================================================
+
+    Per-frame work is split in two:
+
+      computeFrameParams()  advances the DDS oscillators to the session
+                            time and evaluates all per-frame scalars
+                            (program level, breathing, modulation,
+                            mandala mode) from the session program.
+      renderFrame()         fills the LED buffer from those scalars.
+
+    renderFrame() has two interchangeable implementations, chosen by
+    RENDER_FIXED_POINT in config.h:
+
+      renderFrameFloat()    float reference path
+      renderFrameQ15()      integer-only, saturating Q15 path; its LED
+                            buffer matches the float path's to within
+                            2 LSB per channel (1 LSB once through the
+                            output curve and master level)
+
+    Both are always compiled so they can be compared on the host:
+    tools/q15_check enforces the 2 LSB, golden_check_q15 the 1 LSB.
+*/
+
+#pragma once
+
+#include <FastLED.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "dds.h"
+#include "fixed_point.h"
+#include "session_program.h"
+
+/* ---------------- SAFETY UTILITIES -------------------- */
+
+inline uint8_t safeClampInt(int v) {
+    if (v < 0) return 0;
+    if (v > 255) return 255;
+    return (uint8_t)v;
+}
+
+inline float clamp01(float v) {
+    return (v < 0.0f) ? 0.0f : ((v > 1.0f) ? 1.0f : v);
+}
+
+inline float clamp(float v, float min, float max) {
+    if (v < min) return min;
+    if (v > max) return max;
+    return v;
+}
+
+/* ---------------- COLORS (research-optimized) ------------ */
+const CRGB LEFT_COLOR   = CRGB(255, 120, 40);   // Warm orange
+const CRGB RIGHT_COLOR  = CRGB(40, 130, 255);   // Cool blue
+const CRGB CENTER_COLOR = CRGB(255, 200, 90);   // Warm amber
+
+/* ---------------- PER-FRAME STATE ---------------- */
+
+struct FrameParams {
+    float    t;                // session time, seconds
+    int      mandalaMode;      // 0 radial, 1 spiral, 2 interference
+    float    rampMul;          // program level (ramp-in, fades), 0..1
+    float    breathe;          // breathing envelope
+    float    micro;            // micro shimmer (1.0 when disabled)
+    float    master;           // output level, sessionLevel(t); applied by the output pass
+    float    finalL;           // left amplitude with all envelopes, 0..1
+    float    finalR;           // right amplitude with all envelopes, 0..1
+
+    // Q0.32 phases sampled from the DDS oscillators
+    uint32_t phaseLeft;
+    uint32_t phaseRight;
+    uint32_t phaseCarrier;
+    uint32_t phaseSpiralLeft;
+    uint32_t phaseSpiralRight;
+    uint32_t phaseSpiralBody;
+};
+
+/*
+    Reset the global bank to phase 0 at the start of the active program.
+*/
+void initOscillators();
+
+/*
+    Advance oscillators to `sessionUs` and evaluate per-frame scalars.
+    The one-argument form uses the sketch's global bank.
+*/
+FrameParams computeFrameParams(OscillatorBank &bank, uint64_t sessionUs);
+FrameParams computeFrameParams(uint64_t sessionUs);
+
+/* ---------------- SESSION ENVELOPE ---------------- */
+
+/*
+    End of the stimulus: the end of the active program, capped at the
+    MAX_SESSION_SECONDS safety limit.
+*/
+float sessionEndSeconds();
+
+/*
+    Master output level at session time `t`, 0..1 of full drive:
+    GLOBAL_BRIGHTNESS (as FastLED would apply it, (GLOBAL_BRIGHTNESS + 1)
+    / 256), then a quadratic fade over FADE_OUT_SECONDS once
+    sessionEndSeconds() is up. The output pass multiplies every pixel by
+    it at 16 bits (gamma.h), so the fade has no brightness-byte steps.
+*/
+float sessionLevel(float t);
+
+// The fade-out has reached black; the session is over.
+bool sessionFinished(float t);
+
+/* ---------------- FLOAT KERNELS ---------------- */
+
+// Per-LED masks, 0..1, at a topology coordinate in turns: `pos` is
+// Topology::spiral, `petal` Topology::petal
+float spiralMask(float pos, float shift);
+float radialMask(float petal, float phase, int petals = 8);
+float interferenceMask(float pos, float phaseL, float phaseR);
+
+CRGB mixColor(const CRGB &a, const CRGB &b, float w);
+
+// Pulse modulation shaping (MOD_PULSE), per frame in computeFrameParams()
+float getEnhancedPhase(float basePhase, float syncStrength);
+float expPulse(float phase, float sharpness);
+
+// Q0.32 phase -> 0..1 float, same rounding as Oscillator::phase01()
+inline float phase01(uint32_t phaseQ32) {
+    return (float)(phaseQ32 >> 8) * (1.0f / 16777216.0f);
+}
+
+/* ---------------- Q15 KERNELS ---------------- */
+
+// The same masks at Q0.32 topology coordinates (Topology::spiralQ32,
+// petalQ32) and phases, Q15 results (1.0 == Q15_ONE)
+q15_t spiralMaskQ15(uint32_t pos, uint32_t shift);
+q15_t radialMaskQ15(uint32_t petal, uint32_t phase, int petals = 8);
+q15_t interferenceMaskQ15(uint32_t pos, uint32_t phaseL, uint32_t phaseR);
+
+CRGB mixColorQ15(const CRGB &a, const CRGB &b, q15_t w);
+
+/* ---------------- RENDER PATHS ---------------- */
+
+void renderFrameFloat(const FrameParams &fp, CRGB *leds);
+void renderFrameQ15(const FrameParams &fp, CRGB *leds);
+
+/*
+    The last stage of each path: the edge core over the outermost
+    EDGE_LEDS ranks plus the reflection echo of the body LEDs they
+    mirror, so it runs after the body.
+*/
+void renderEchoFloat(const FrameParams &fp, CRGB *leds);
+void renderEchoQ15(const FrameParams &fp, CRGB *leds);
+
+inline void renderFrame(const FrameParams &fp, CRGB *leds) {
+#if RENDER_FIXED_POINT
+    renderFrameQ15(fp, leds);
+#else
+    renderFrameFloat(fp, leds);
+#endif
+}
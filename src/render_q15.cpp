@@ -0,0 +1,153 @@
+/*
+    Integer-only render path. Same frame as renderFrameFloat(), computed
+    per LED with saturating Q15 arithmetic and the Q15 sine table. Only the
+    handful of per-frame scalars in FrameParams are converted from float.
+*/
+
+#include "render.h"
+
+#include "fixed_point.h"
+#include "profiler.h"
+#include "topology.h"
+#include "trig.h"
+
+constexpr q15_t SPIRAL_FLOOR_Q15     = q15FromFloat(0.2f);
+constexpr q15_t STEREO_NEAR_Q15      = q15FromFloat(0.8f);
+constexpr q15_t STEREO_FAR_Q15       = Q15_ONE - STEREO_NEAR_Q15;
+constexpr q15_t REFLECTION_DECAY_Q15 = q15FromFloat(REFLECTION_DECAY);
+
+/* ---------------- MANDALA + GEOMETRY MASKS (Q15) ---------------- */
+
+// Positions are Q0.32 turns, the topology table's spiralQ32/petalQ32
+
+q15_t spiralMaskQ15(uint32_t posQ32, uint32_t shiftQ32) {
+    // Circular distance |pos - shift| folded to 0..0.5 turn
+    uint32_t diff = posQ32 - shiftQ32;
+    uint32_t d = (diff > 0x80000000u) ? (0u - diff) : diff;
+
+    // 1 - 2d + 0.2; (d >> 16) is 2d in Q15
+    return q15Sat01(Q15_ONE - (q15_t)(d >> 16) + SPIRAL_FLOOR_Q15);
+}
+
+q15_t radialMaskQ15(uint32_t petalQ32, uint32_t phaseQ32, int petals) {
+    uint32_t angle = petalQ32 * (uint32_t)petals;
+    return q15Sat01((sinQ15(phaseQ32 + angle) + Q15_ONE) >> 1);
+}
+
+q15_t interferenceMaskQ15(uint32_t pos, uint32_t phaseL, uint32_t phaseR) {
+    q15_t A = sinQ15(phaseL + pos);
+    q15_t B = sinQ15(phaseR - pos);
+    return q15Sat01(((A + B) >> 2) + (Q15_ONE >> 1));
+}
+
+/* ---------------- COLOR UTILITIES (Q15) ---------------- */
+
+CRGB mixColorQ15(const CRGB &a, const CRGB &b, q15_t w) {
+    q15_t iw = Q15_ONE - w;
+    return CRGB(
+        safeClampInt((a.r * iw + b.r * w) >> 15),
+        safeClampInt((a.g * iw + b.g * w) >> 15),
+        safeClampInt((a.b * iw + b.b * w) >> 15)
+    );
+}
+
+inline CRGB scaleColorQ15(const CRGB &c, q15_t amp) {
+    return CRGB(q15ScaleU8(c.r, amp), q15ScaleU8(c.g, amp), q15ScaleU8(c.b, amp));
+}
+
+/* ---------------- MASK POLICIES (Q15) ---------------- */
+
+// Same structure as the float path: per-frame setup and table column in
+// the constructor, per-LED mask at spiral rank r in operator()
+struct RadialMaskQ15 {
+    const uint32_t *petal;
+    uint32_t phase;
+    RadialMaskQ15(const FrameParams &fp, const Topology &t) : petal(t.petalQ32), phase(fp.phaseCarrier) {}
+    q15_t operator()(int r) const { return radialMaskQ15(petal[r], phase, 8); }
+};
+
+struct SpiralMaskQ15 {
+    const uint32_t *spiral;
+    uint32_t shift;
+    SpiralMaskQ15(const FrameParams &fp, const Topology &t) : spiral(t.spiralQ32), shift(fp.phaseSpiralBody) {}
+    q15_t operator()(int r) const { return spiralMaskQ15(spiral[r], shift); }
+};
+
+struct InterferenceMaskQ15 {
+    const uint32_t *spiral;
+    uint32_t phaseL, phaseR;
+    InterferenceMaskQ15(const FrameParams &fp, const Topology &t)
+        : spiral(t.spiralQ32), phaseL(fp.phaseLeft), phaseR(fp.phaseRight) {}
+    q15_t operator()(int r) const { return interferenceMaskQ15(spiral[r], phaseL, phaseR); }
+};
+
+struct BodyInvariantsQ15 {
+    CRGB  blended;
+    q15_t amp[2];   // by eye
+};
+
+template <typename Mask>
+static void renderBodyQ15(const FrameParams &fp, const BodyInvariantsQ15 &inv, const Topology &t, CRGB *leds) {
+    const Mask maskAt(fp, t);
+
+    uint32_t c0 = profileStamp();
+    for (int r = ANCHOR_LEDS; r < NUM_LEDS - EDGE_LEDS; ++r) {
+        q15_t mask = maskAt(r);
+        q15_t mixedAmp = q15Sat01(q15Mul(mask, inv.amp[t.eye[r]]));
+        leds[t.led[r]] = scaleColorQ15(inv.blended, mixedAmp);
+    }
+    profileRecord(PROF_BODY, profileStamp() - c0);
+}
+
+using BodyKernelQ15 = void (*)(const FrameParams &, const BodyInvariantsQ15 &, const Topology &, CRGB *);
+
+// Indexed by FrameParams::mandalaMode
+static const BodyKernelQ15 BODY_KERNELS_Q15[3] = {
+    renderBodyQ15<RadialMaskQ15>,
+    renderBodyQ15<SpiralMaskQ15>,
+    renderBodyQ15<InterferenceMaskQ15>,
+};
+
+/* ---------------- Q15 RENDER PATH ---------------- */
+
+void renderFrameQ15(const FrameParams &fp, CRGB *leds) {
+    const Topology &t = topology();
+    const q15_t finalL = q15FromUnit(fp.finalL);
+    const q15_t finalR = q15FromUnit(fp.finalR);
+
+    // ----------- CENTER ANCHORS ------------
+    const CRGB center = scaleColorQ15(CENTER_COLOR, q15Sat01((finalL + finalR) >> 1));
+    for (int r = 0; r < ANCHOR_LEDS; ++r) leds[t.led[r]] = center;
+
+    // ----------- MAIN BODY PATTERNS ------------
+    BodyInvariantsQ15 inv;
+    inv.blended = mixColorQ15(CENTER_COLOR,
+                              mixColorQ15(LEFT_COLOR, RIGHT_COLOR, Q15_ONE / 2),
+                              q15FromFloat(0.6f));
+    inv.amp[0] = q15Mul(STEREO_NEAR_Q15, finalL) + q15Mul(STEREO_FAR_Q15, finalR);
+    inv.amp[1] = q15Mul(STEREO_FAR_Q15, finalL) + q15Mul(STEREO_NEAR_Q15, finalR);
+    BODY_KERNELS_Q15[fp.mandalaMode](fp, inv, t, leds);
+
+    renderEchoQ15(fp, leds);
+}
+
+/* ---------------- EDGE CORE + REFLECTION ECHO (Q15) ---------------- */
+
+void renderEchoQ15(const FrameParams &fp, CRGB *leds) {
+    const Topology &t = topology();
+    const q15_t finalR = q15FromUnit(fp.finalR);
+
+    uint32_t c0 = profileStamp();
+    for (int r = NUM_LEDS - EDGE_LEDS; r < NUM_LEDS; ++r) {
+        q15_t mask = spiralMaskQ15(t.spiralQ32[r], fp.phaseSpiralRight);
+        CRGB px = scaleColorQ15(RIGHT_COLOR, q15Mul(finalR, mask));
+        if (t.echo[r] >= 0) {
+            const CRGB &src = leds[t.led[t.echo[r]]];
+            px.r = qadd8(px.r, q15ScaleU8(src.r, REFLECTION_DECAY_Q15));
+            px.g = qadd8(px.g, q15ScaleU8(src.g, REFLECTION_DECAY_Q15));
+            px.b = qadd8(px.b, q15ScaleU8(src.b, REFLECTION_DECAY_Q15));
+        }
+        leds[t.led[r]] = px;
+    }
+    profileRecord(PROF_ECHO, profileStamp() - c0);
+}
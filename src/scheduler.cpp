@@ -0,0 +1,121 @@
+#include "scheduler.h"
+
+#include <atomic>
+
+#include "clock.h"
+
+#if defined(ARDUINO)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#endif
+
+/* ---------------- PLATFORM SLEEP ---------------- */
+
+// Set by wakeSchedulerFromIsr(), consumed by the sleeper
+static std::atomic<bool> sleepInterrupted(false);
+
+#if defined(ARDUINO)
+
+// One-shot timer armed per frame; its callback wakes the waiting task.
+static esp_timer_handle_t wakeTimer = nullptr;
+static TaskHandle_t       wakeTask  = nullptr;
+
+static void onWakeTimer(void *) {
+    xTaskNotifyGive(wakeTask);
+}
+
+void sleepUntilMicros(uint64_t deadlineUs) {
+    uint64_t now = getTimeMicros();
+    if (now >= deadlineUs) return;
+
+    if (wakeTimer == nullptr) {
+        esp_timer_create_args_t args = {};
+        args.callback = &onWakeTimer;
+        args.name = "frame";
+        esp_timer_create(&args, &wakeTimer);
+    }
+    wakeTask = xTaskGetCurrentTaskHandle();
+    esp_timer_start_once(wakeTimer, deadlineUs - now);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (sleepInterrupted.exchange(false)) esp_timer_stop(wakeTimer);
+}
+
+void IRAM_ATTR wakeSchedulerFromIsr() {
+    sleepInterrupted = true;
+    if (wakeTask == nullptr) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(wakeTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+#else
+
+void sleepUntilMicros(uint64_t deadlineUs) {
+    uint64_t now = getTimeMicros();
+    if (now >= deadlineUs) return;
+
+    if (hostClockSimulated) {
+        // Stop at an injected interrupt if it asks for a wake-up
+        while (now < deadlineUs) {
+            if (sleepInterrupted.exchange(false)) return;
+            hostClockAdvanceMicros(deadlineUs - now, true);
+            now = getTimeMicros();
+        }
+        sleepInterrupted = false;
+        return;
+    }
+    uint64_t target = deadlineUs + clockEpochMicros;
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(target / 1000000ULL);
+    ts.tv_nsec = (long)(target % 1000000ULL) * 1000L;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) != 0) {
+        // EINTR: keep sleeping to the same absolute deadline
+    }
+}
+
+void wakeSchedulerFromIsr() {
+    sleepInterrupted = true;
+}
+
+#endif
+
+/* ---------------- DEADLINE ACCOUNTING ---------------- */
+
+void FrameScheduler::begin(uint64_t nowUs, uint32_t period) {
+    startUs   = nowUs;
+    periodUs  = period;
+    nextIndex = 0;
+    stats     = {};
+}
+
+FrameTick FrameScheduler::waitForNextFrame() {
+    sleepUntilMicros(nextDeadlineUs());
+    return tick(getTimeMicros());
+}
+
+FrameTick FrameScheduler::tick(uint64_t nowUs) {
+    uint64_t elapsed = (nowUs > startUs) ? nowUs - startUs : 0;
+    uint32_t k = (uint32_t)(elapsed / periodUs);
+    if (k < nextIndex) k = nextIndex;   // started early: use the pending deadline
+
+    FrameTick frame;
+    frame.index   = k;
+    frame.idealUs = startUs + (uint64_t)k * periodUs;
+    frame.startUs = nowUs;
+    frame.dropped = k - nextIndex;
+    nextIndex = k + 1;
+
+    uint32_t latency = (nowUs > frame.idealUs) ? (uint32_t)(nowUs - frame.idealUs) : 0;
+    stats.frames++;
+    stats.dropped += frame.dropped;
+    if (latency > stats.maxStartLatencyUs) stats.maxStartLatencyUs = latency;
+    return frame;
+}
+
+void FrameScheduler::endFrame(const FrameTick &frame, uint64_t nowUs) {
+    uint32_t frameUs = (nowUs > frame.idealUs) ? (uint32_t)(nowUs - frame.idealUs) : 0;
+    if (frameUs > stats.maxFrameUs) stats.maxFrameUs = frameUs;
+    if (frameUs > periodUs) stats.late++;
+}
@@ -0,0 +1,83 @@
+/*
+    ================================================================
+                   DEADLINE-BASED FRAME SCHEDULER
+    ================================================================
+
+    Frames are due at exact microsecond deadlines start + k * period.
+    waitForNextFrame() sleeps until the next deadline instead of spinning:
+
+    • ESP32: a one-shot esp_timer (same 1 μs counter as clock.h), armed
+      for each deadline in turn, sends a FreeRTOS task notification to
+      the render task, which blocks in ulTaskNotifyTake() until it fires.
+    • Host: clock_nanosleep() to the absolute deadline, or, when the host
+      clock is simulated, the clock simply jumps to the deadline.
+
+    Every frame is stamped against its ideal time. A frame that finishes
+    after the next deadline counts as late; deadlines that pass without a
+    frame starting count as dropped.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+struct FrameTick {
+    uint32_t index;       // deadline number since begin()
+    uint64_t idealUs;     // ideal start time of this frame
+    uint64_t startUs;     // when the frame actually started
+    uint32_t dropped;     // deadlines skipped right before this frame
+};
+
+struct SchedulerStats {
+    uint32_t frames;              // frames started
+    uint32_t dropped;             // deadlines that never got a frame
+    uint32_t late;                // frames finished after the next deadline
+    uint32_t maxStartLatencyUs;   // worst startUs - idealUs
+    uint32_t maxFrameUs;          // worst endFrame() - idealUs
+};
+
+struct FrameScheduler {
+    uint64_t startUs   = 0;
+    uint32_t periodUs  = 0;
+    uint32_t nextIndex = 0;   // first deadline not yet used by a frame
+    SchedulerStats stats = {};
+
+    /*
+        Start the deadline grid at `nowUs` (first frame due immediately).
+    */
+    void begin(uint64_t nowUs, uint32_t period);
+
+    /*
+        Block until the next deadline, then account for it like tick().
+    */
+    FrameTick waitForNextFrame();
+
+    /*
+        Deadline bookkeeping for a frame starting at `nowUs`, with no
+        waiting. Picks the most recent deadline not already used.
+    */
+    FrameTick tick(uint64_t nowUs);
+
+    /*
+        Stamp the end of the frame (after show()) against its ideal time.
+    */
+    void endFrame(const FrameTick &frame, uint64_t nowUs);
+
+    uint64_t nextDeadlineUs() const {
+        return startUs + (uint64_t)nextIndex * periodUs;
+    }
+};
+
+/*
+    Sleep the calling task until the clock reaches `deadlineUs`
+    (getTimeMicros() time base). Returns immediately if already past.
+*/
+void sleepUntilMicros(uint64_t deadlineUs);
+
+/*
+    Cut a sleepUntilMicros() short (or make the next one return at once)
+    so the render task reacts to an event before its next deadline.
+    Callable from an ISR. On the real-time host clock the sleep runs to
+    its deadline.
+*/
+void wakeSchedulerFromIsr();
@@ -0,0 +1,250 @@
+#include "session_program.h"
+
+#include <math.h>
+
+#include "render.h"
+
+/* ---------------- BUILT-IN PROGRAMS ---------------- */
+
+constexpr Modulation CONFIG_MODULATION = USE_SINUSOIDAL_MODULATION ? MOD_SINE : MOD_PULSE;
+
+// The fixed protocol from config.h: smoothstep ramp-in, then hold
+static const SessionSegment CONFIG_PROTOCOL[] = {
+    { RAMP_IN_SECONDS, LEFT_FREQ_HZ, RIGHT_FREQ_HZ, SWEEP_HOLD, 1.0f, LEVEL_SMOOTHSTEP,
+      CONFIG_MODULATION, MANDALA_CYCLE },
+    { MAX_SESSION_SECONDS - RAMP_IN_SECONDS, LEFT_FREQ_HZ, RIGHT_FREQ_HZ, SWEEP_HOLD, 1.0f, LEVEL_HOLD,
+      CONFIG_MODULATION, MANDALA_CYCLE },
+};
+
+// Settle at the alpha/theta border, then walk both eyes down into theta
+static const SessionSegment THETA_DESCENT[] = {
+    {  90.0f, 8.0f, 8.0f, SWEEP_HOLD,   0.8f, LEVEL_SMOOTHSTEP, MOD_SINE, 0 },
+    { 120.0f, 8.0f, 8.0f, SWEEP_HOLD,   0.8f, LEVEL_HOLD,       MOD_SINE, 0 },
+    { 600.0f, 5.8f, 6.2f, SWEEP_LINEAR, 1.0f, LEVEL_LINEAR,     MOD_SINE, 1 },
+    { 990.0f, 5.8f, 6.2f, SWEEP_HOLD,   1.0f, LEVEL_HOLD,       MOD_SINE, MANDALA_CYCLE },
+};
+
+// Same walk at a constant rate in octaves, so it slows down as it goes
+static const SessionSegment EXPONENTIAL_DESCENT[] = {
+    {  60.0f, 8.0f, 8.0f, SWEEP_HOLD,        0.8f, LEVEL_SMOOTHSTEP, MOD_SINE, 0 },
+    { 900.0f, 5.5f, 6.0f, SWEEP_EXPONENTIAL, 1.0f, LEVEL_LINEAR,     MOD_SINE, MANDALA_CYCLE },
+    { 840.0f, 5.5f, 6.0f, SWEEP_HOLD,        1.0f, LEVEL_HOLD,       MOD_SINE, MANDALA_CYCLE },
+};
+
+#define PROGRAM(name, segments) { name, segments, sizeof(segments) / sizeof(segments[0]) }
+
+const SessionProgram SESSION_PROGRAMS[] = {
+    PROGRAM("config protocol", CONFIG_PROTOCOL),
+    PROGRAM("theta descent", THETA_DESCENT),
+    PROGRAM("exponential descent", EXPONENTIAL_DESCENT),
+};
+const int SESSION_PROGRAM_COUNT = sizeof(SESSION_PROGRAMS) / sizeof(SESSION_PROGRAMS[0]);
+
+#undef PROGRAM
+
+/* ---------------- COMPILER ---------------- */
+
+// DDS increments of every oscillator for a pair of eye frequencies
+static void oscillatorIncrements(float leftHz, float rightHz, uint64_t inc[OSC_COUNT]) {
+    float carrier = carrierHz(leftHz, rightHz);
+    inc[OSC_LEFT]         = ddsIncrement(leftHz);
+    inc[OSC_RIGHT]        = ddsIncrement(rightHz);
+    inc[OSC_CARRIER]      = ddsIncrement(carrier);
+    inc[OSC_BREATH]       = ddsIncrement(BREATH_FREQ_HZ);
+    inc[OSC_MICRO]        = ddsIncrement(MICRO_FREQ_HZ);
+    inc[OSC_SPIRAL_LEFT]  = ddsIncrement(spiralCoreSpeed(leftHz));
+    inc[OSC_SPIRAL_RIGHT] = ddsIncrement(spiralCoreSpeed(rightHz));
+    inc[OSC_SPIRAL_BODY]  = ddsIncrement(spiralBodySpeed(carrier));
+}
+
+static bool fail(CompiledProgram &out, const char *why, int segment) {
+    out.error = why;
+    out.errorSegment = segment;
+    out.count = 0;
+    return false;
+}
+
+static const char *checkSegment(const SessionSegment &s) {
+    // Chirp sums stay exact for spans under 2^32 us (~71 minutes)
+    if (!(s.seconds > 0.0f) || s.seconds * 1e6f >= 4294967296.0f) return "duration out of range";
+    if (!(s.leftHz >= MIN_FREQ_HZ && s.leftHz <= MAX_FREQ_HZ) ||
+        !(s.rightHz >= MIN_FREQ_HZ && s.rightHz <= MAX_FREQ_HZ)) return "frequency outside MIN_FREQ_HZ..MAX_FREQ_HZ";
+    if (!(s.level >= 0.0f && s.level <= 1.0f)) return "level outside 0..1";
+    if (s.sweep > SWEEP_EXPONENTIAL) return "unknown sweep curve";
+    if (s.levelCurve > LEVEL_SMOOTHSTEP) return "unknown level curve";
+    if (s.modulation > MOD_PULSE) return "unknown modulation";
+    if (s.mandalaMode < MANDALA_CYCLE || s.mandalaMode > 2) return "unknown mandala mode";
+    return nullptr;
+}
+
+/*
+    Chirp pieces for an exponential sweep by `ratio`. A straight line
+    through points on f0 * ratio^u misses the curve by at most
+    (ln ratio / pieces)^2 / 8 of the frequency.
+*/
+static int exponentialPieces(double ratio) {
+    double perPiece = sqrt(8.0 * (double)EXP_SWEEP_TOLERANCE);
+    int pieces = (int)ceil(fabs(log(ratio)) / perPiece);
+    return (pieces < 1) ? 1 : pieces;
+}
+
+bool compileSessionProgram(const SessionProgram &src, CompiledProgram &out) {
+    out.name = src.name;
+    out.source = &src;
+    out.error = nullptr;
+    out.errorSegment = -1;
+    if (src.count == 0) return fail(out, "no segments", -1);
+
+    uint64_t startUs = 0;
+    uint64_t inc[OSC_COUNT];   // exact increment at the current time
+    float prevLeftHz = src.segments[0].leftHz;
+    float prevRightHz = src.segments[0].rightHz;
+    float prevLevel = 0.0f;    // every program starts dark
+    float holdSeconds = 1.0f / BREATH_FREQ_HZ;
+    oscillatorIncrements(prevLeftHz, prevRightHz, inc);
+    int n = 0;
+
+    for (int i = 0; i < src.count; ++i) {
+        const SessionSegment &s = src.segments[i];
+        if (const char *why = checkSegment(s)) return fail(out, why, i);
+        // A held pair beats for the whole segment; a sweep only passes through
+        if (s.sweep == SWEEP_HOLD) holdSeconds = fmaxf(holdSeconds, slowestModulationSeconds(s.leftHz, s.rightHz));
+
+        uint64_t durationUs = (uint64_t)llround((double)s.seconds * 1e6);
+        double ratioL = (double)s.leftHz / prevLeftHz;
+        double ratioR = (double)s.rightHz / prevRightHz;
+        int pieces = 1;
+        if (s.sweep == SWEEP_EXPONENTIAL) {
+            int pl = exponentialPieces(ratioL), pr = exponentialPieces(ratioR);
+            pieces = (pl > pr) ? pl : pr;
+        }
+
+        for (int p = 0; p < pieces; ++p) {
+            if (n + 1 >= MAX_PROGRAM_RECORDS) return fail(out, "needs more than MAX_PROGRAM_RECORDS records", i);
+            uint64_t pieceStart = startUs + durationUs * p / pieces;
+            uint64_t pieceEnd   = startUs + durationUs * (p + 1) / pieces;
+
+            // Where this record has to end up
+            uint64_t target[OSC_COUNT];
+            if (s.sweep == SWEEP_EXPONENTIAL) {
+                double u = (double)(p + 1) / pieces;
+                oscillatorIncrements((float)(prevLeftHz * pow(ratioL, u)),
+                                     (float)(prevRightHz * pow(ratioR, u)), target);
+            } else {
+                oscillatorIncrements(s.leftHz, s.rightHz, target);
+            }
+
+            ProgramRecord &rec = out.records[n++];
+            rec.startUs = pieceStart;
+            for (int k = 0; k < OSC_COUNT; ++k) {
+                if (s.sweep == SWEEP_HOLD) {
+                    rec.incPerUs[k]   = target[k];
+                    rec.chirpPerUs[k] = 0;
+                    inc[k] = target[k];
+                } else {
+                    // Start where the last piece really ended, so the
+                    // rounding of one chirp never becomes a frequency step
+                    uint64_t span = pieceEnd - pieceStart;
+                    int64_t delta = (int64_t)(target[k] - inc[k]);
+                    rec.incPerUs[k]   = inc[k];
+                    rec.chirpPerUs[k] = llround((double)delta / (double)span);
+                    inc[k] += (uint64_t)rec.chirpPerUs[k] * span;
+                }
+            }
+            rec.startSeconds = (float)((double)startUs * 1e-6);
+            rec.seconds      = s.seconds;
+            rec.levelFrom    = prevLevel;
+            rec.levelTo      = s.level;
+            rec.levelCurve   = s.levelCurve;
+            rec.modulation   = s.modulation;
+            rec.mandalaMode  = s.mandalaMode;
+            rec.segment      = (uint16_t)i;
+        }
+
+        prevLeftHz = s.leftHz;
+        prevRightHz = s.rightHz;
+        prevLevel = s.level;
+        startUs += durationUs;
+    }
+
+    // Terminal record: hold the final state after the last segment
+    const SessionSegment &last = src.segments[src.count - 1];
+    ProgramRecord &end = out.records[n++];
+    end.startUs = startUs;
+    for (int k = 0; k < OSC_COUNT; ++k) {
+        end.incPerUs[k]   = inc[k];
+        end.chirpPerUs[k] = 0;
+    }
+    end.startSeconds = (float)((double)startUs * 1e-6);
+    end.seconds      = 0.0f;
+    end.levelFrom    = prevLevel;
+    end.levelTo      = prevLevel;
+    end.levelCurve   = LEVEL_HOLD;
+    end.modulation   = last.modulation;
+    end.mandalaMode  = last.mandalaMode;
+    end.segment      = src.count;
+
+    out.count = (uint16_t)n;
+    out.seconds = end.startSeconds;
+    // The terminal record holds the last frequencies, swept there or not
+    out.holdSeconds = fmaxf(holdSeconds, slowestModulationSeconds(last.leftHz, last.rightHz));
+    return true;
+}
+
+float programLevel(const ProgramRecord &rec, float t) {
+    if (rec.levelCurve == LEVEL_HOLD) return rec.levelTo;
+    float u = clamp01((t - rec.startSeconds) / rec.seconds);
+    if (rec.levelCurve == LEVEL_SMOOTHSTEP) u = u * u * (3.0f - 2.0f * u);
+    return rec.levelFrom + (rec.levelTo - rec.levelFrom) * u;
+}
+
+int programMandalaMode(const ProgramRecord &rec, float t) {
+    if (rec.mandalaMode == MANDALA_CYCLE) return ((int)(t / MODE_DURATION)) % 3;
+    return rec.mandalaMode;
+}
+
+/* ---------------- ACTIVE PROGRAM ---------------- */
+
+static CompiledProgram active;
+
+bool loadSessionProgram(int index) {
+    if (index < 0 || index >= SESSION_PROGRAM_COUNT) {
+        active.name = nullptr;
+        active.source = nullptr;
+        return fail(active, "no such program", -1);
+    }
+    return compileSessionProgram(SESSION_PROGRAMS[index], active);
+}
+
+const CompiledProgram &activeProgram() {
+    return active;
+}
+
+/* ---------------- PROGRAM EVALUATION ---------------- */
+
+void OscillatorBank::init(const CompiledProgram &prog) {
+    program = &prog;
+    for (Oscillator &o : osc) o = Oscillator();
+    enter(0);
+}
+
+void OscillatorBank::enter(uint16_t index) {
+    const ProgramRecord &rec = program->records[index];
+    for (int k = 0; k < OSC_COUNT; ++k) {
+        osc[k].advanceTo(rec.startUs);
+        osc[k].incPerUs   = rec.incPerUs[k];
+        osc[k].chirpPerUs = rec.chirpPerUs[k];
+    }
+    cursor = index;
+}
+
+void OscillatorBank::seek(uint64_t sessionUs) {
+    // Phase is only defined by integrating from 0; replay the boundaries
+    if (sessionUs < osc[0].lastUs) init(*program);
+    advanceTo(sessionUs);
+}
+
+void OscillatorBank::advanceTo(uint64_t sessionUs) {
+    while (cursor + 1 < program->count && sessionUs >= program->records[cursor + 1].startUs) enter(cursor + 1);
+    for (int k = 0; k < OSC_COUNT; ++k) osc[k].advanceTo(sessionUs);
+}
@@ -0,0 +1,168 @@
+/*
+    ================================================================
+                       SESSION PROGRAM ENGINE
+    ================================================================
+
+    A session is a timeline of segments. Each segment gives target eye
+    frequencies and how to reach them (held, or a linear or exponential
+    chirp), a stimulus level and its curve, the modulation type and the
+    mandala mode. Programs are const tables (SESSION_PROGRAMS, in flash on
+    the ESP32), selected with SESSION_PROGRAM in config.h.
+
+    At boot compileSessionProgram() validates the table and turns it into
+    a flat RAM array of ProgramRecord: absolute start time, the DDS
+    increment and chirp rate of every oscillator, and the level/mode
+    fields. OscillatorBank keeps a cursor into that array which only ever
+    steps forward, so per-frame evaluation is O(1) with no searching.
+
+    Every sweep is integrated by the DDS accumulators themselves: a linear
+    sweep is one chirp record, an exponential sweep is split into linear
+    chirp pieces through points on the exponential, within
+    EXP_SWEEP_TOLERANCE. Each piece starts from the exact increment the
+    previous one ended on, so frequency is continuous through a sweep and
+    phase is continuous everywhere. Phase is exact integer arithmetic:
+    seeking to any time gives the same phases as advancing frame by frame.
+    The host build evaluates the same code (tools/program_check).
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+#include "dds.h"
+
+/* ---------------- AUTHORING FORMAT ---------------- */
+
+enum SweepCurve : uint8_t {
+    SWEEP_HOLD,         // jump to the segment's frequencies at its start
+    SWEEP_LINEAR,       // linear chirp from the previous segment's frequencies
+    SWEEP_EXPONENTIAL,  // constant ratio per second (equal octaves per minute)
+};
+
+enum LevelCurve : uint8_t {
+    LEVEL_HOLD,        // jump to the target level at the start
+    LEVEL_LINEAR,
+    LEVEL_SMOOTHSTEP,  // from the previous level, zero slope at both ends
+};
+
+enum Modulation : uint8_t {
+    MOD_SINE,    // raised sine (lowest harmonics)
+    MOD_PULSE,   // phase-enhanced exponential pulse
+};
+
+constexpr int8_t MANDALA_CYCLE = -1;   // rotate modes every MODE_DURATION
+
+struct SessionSegment {
+    float      seconds;      // duration, > 0
+    float      leftHz;       // eye frequencies at the end of the segment,
+    float      rightHz;      // MIN_FREQ_HZ..MAX_FREQ_HZ
+    SweepCurve sweep;
+    float      level;        // stimulus level at the end, 0..1
+    LevelCurve levelCurve;
+    Modulation modulation;
+    int8_t     mandalaMode;  // 0 radial, 1 spiral, 2 interference, or MANDALA_CYCLE
+};
+
+struct SessionProgram {
+    const char           *name;
+    const SessionSegment *segments;
+    uint16_t              count;
+};
+
+// Built-in programs, indexed by SESSION_PROGRAM
+extern const SessionProgram SESSION_PROGRAMS[];
+extern const int            SESSION_PROGRAM_COUNT;
+
+/* ---------------- COMPILED FORM ---------------- */
+
+enum OscillatorId {
+    OSC_LEFT,
+    OSC_RIGHT,
+    OSC_CARRIER,
+    OSC_BREATH,
+    OSC_MICRO,
+    OSC_SPIRAL_LEFT,
+    OSC_SPIRAL_RIGHT,
+    OSC_SPIRAL_BODY,
+    OSC_COUNT
+};
+
+/*
+    One record per segment, or per chirp piece of an exponential sweep.
+    startSeconds/seconds describe the whole segment (for the level curve).
+*/
+struct ProgramRecord {
+    uint64_t   startUs;
+    uint64_t   incPerUs[OSC_COUNT];     // Q0.64 turns per microsecond at startUs
+    int64_t    chirpPerUs[OSC_COUNT];   // increment change per microsecond
+    float      startSeconds;            // segment start
+    float      seconds;                 // segment length, 0 for the terminal record
+    float      levelFrom;
+    float      levelTo;
+    LevelCurve levelCurve;
+    Modulation modulation;
+    int8_t     mandalaMode;
+    uint16_t   segment;                 // source segment index
+};
+
+/*
+    Records for one program, plus a terminal record that holds the final
+    frequencies and level forever after the last segment ends.
+*/
+struct CompiledProgram {
+    const char           *name = nullptr;
+    const SessionProgram *source = nullptr;
+    ProgramRecord         records[MAX_PROGRAM_RECORDS];
+    uint16_t              count = 0;        // including the terminal record
+    float                 seconds = 0.0f;   // end of the last segment
+    float                 holdSeconds = 0.0f;   // longest held modulation period (power.h)
+
+    // Why compilation failed, and in which segment (-1: whole program)
+    const char           *error = nullptr;
+    int                   errorSegment = -1;
+};
+
+bool compileSessionProgram(const SessionProgram &src, CompiledProgram &out);
+
+// Stimulus level of `rec` at session time `t` (seconds)
+float programLevel(const ProgramRecord &rec, float t);
+
+// Mandala mode of `rec` at session time `t`
+int programMandalaMode(const ProgramRecord &rec, float t);
+
+/*
+    Compile SESSION_PROGRAMS[index] as the program every oscillator bank
+    runs. On false, activeProgram().error says why and it must not run.
+*/
+bool loadSessionProgram(int index);
+const CompiledProgram &activeProgram();
+
+/* ---------------- PROGRAM EVALUATION ---------------- */
+
+/*
+    One integer phase accumulator per periodic component, driven by the
+    active program. The sketch renders from a single global bank; offline
+    tools give each worker its own bank and seek() it to the start of its
+    slice of the session.
+*/
+struct OscillatorBank {
+    Oscillator             osc[OSC_COUNT];
+    const CompiledProgram *program = nullptr;
+    uint16_t               cursor = 0;
+
+    // Phase 0 at session time 0, at the start of `prog`
+    void init(const CompiledProgram &prog = activeProgram());
+
+    // Jump to `sessionUs`; identical to advancing frame by frame
+    void seek(uint64_t sessionUs);
+
+    // Time only moves forward; crosses segment boundaries exactly
+    void advanceTo(uint64_t sessionUs);
+
+    // Segment the bank was last advanced into
+    const ProgramRecord &segment() const { return program->records[cursor]; }
+
+private:
+    void enter(uint16_t index);
+};
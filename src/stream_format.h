@@ -0,0 +1,58 @@
+/*
+    ================================================================
+                  STREAMED FRAME INPUT WIRE FORMAT
+    ================================================================
+
+    Host → device packets for FRAME_STREAM mode, shared by the firmware
+    (frame_stream.h) and the sender (tools/stream_sender.h). Framed like
+    telemetry (telemetry_format.h), with its own sync word and a 16-bit
+    length. Little-endian, packed:
+
+        0x5A 0xA5           sync
+        uint8_t  type       StreamType
+        uint8_t  reserved   0
+        uint16_t len        payload bytes
+        payload[len]
+        uint16_t crc        CRC-16/CCITT-FALSE over type .. payload
+
+    STREAM_FRAME payload: StreamFrameHeader, then NUM_LEDS x {r, g, b} in
+    physical LED order, as linear drive levels before the output curve
+    and master level. Its length must match the device's NUM_LEDS.
+
+    presentUs is the moment the frame should become visible, on the
+    sender's own clock. The device anchors that clock to its own at the
+    first frame, so only differences matter; they must rise from frame
+    to frame (32 bits: 71 minutes, more than a session).
+
+    A packet whose CRC fails is dropped whole; the receiver resyncs at
+    the next sync word.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+#include "telemetry_format.h"   // crc16Update()
+
+constexpr uint8_t STREAM_SYNC0 = 0x5A;
+constexpr uint8_t STREAM_SYNC1 = 0xA5;
+constexpr int     STREAM_HEADER_BYTES = 6;   // sync, type, reserved, len
+constexpr int     STREAM_CRC_BYTES    = 2;
+
+enum StreamType : uint8_t {
+    STREAM_FRAME = 1,   // StreamFrameHeader + pixels
+    STREAM_END   = 2,   // StreamFrameHeader: go dark at presentUs, session over
+    STREAM_KEY   = 3,   // one console command byte ('s', 'p', ...), as typed
+};
+
+struct __attribute__((packed)) StreamFrameHeader {
+    uint32_t presentUs;
+};
+
+constexpr uint32_t STREAM_FRAME_PAYLOAD = sizeof(StreamFrameHeader) + NUM_LEDS * 3;
+constexpr uint32_t STREAM_MAX_PAYLOAD   = 0xffff;   // len field
+
+// Non-stream builds (benchmarks at 30000 LEDs) compile the receiver too
+static_assert(!USE_FRAME_STREAM || STREAM_FRAME_PAYLOAD <= STREAM_MAX_PAYLOAD,
+              "stream frames limited to 21843 LEDs");
@@ -0,0 +1,171 @@
+#include "telemetry.h"
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "fixed_point.h"
+
+static_assert((TELEMETRY_RING_BYTES & (TELEMETRY_RING_BYTES - 1)) == 0, "ring size must be a power of two");
+
+/* ---------------- PACKET RING ---------------- */
+
+static uint8_t  ring[TELEMETRY_RING_BYTES];
+static uint32_t ringHead = 0;   // next byte written (free-running)
+static uint32_t ringTail = 0;   // next byte sent (free-running)
+static uint16_t nextSeq = 0;
+static uint32_t droppedPackets = 0;
+
+static void ringPut(const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) ring[(ringHead + i) & (TELEMETRY_RING_BYTES - 1)] = data[i];
+    ringHead += len;
+}
+
+static void sendPacket(TelemetryType type, const void *payload, uint8_t len) {
+    uint16_t seq = nextSeq++;
+    uint32_t total = TELEMETRY_HEADER_BYTES + len + TELEMETRY_CRC_BYTES;
+    if (TELEMETRY_RING_BYTES - (ringHead - ringTail) < total) {
+        droppedPackets++;   // the receiver sees the sequence gap
+        return;
+    }
+
+    uint8_t header[TELEMETRY_HEADER_BYTES] = {
+        TELEMETRY_SYNC0, TELEMETRY_SYNC1, (uint8_t)type, len, (uint8_t)seq, (uint8_t)(seq >> 8)
+    };
+    uint16_t crc = crc16Update(CRC16_INIT, header + 2, TELEMETRY_HEADER_BYTES - 2);
+    crc = crc16Update(crc, (const uint8_t *)payload, len);
+    uint8_t trailer[TELEMETRY_CRC_BYTES] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+
+    ringPut(header, sizeof(header));
+    ringPut((const uint8_t *)payload, len);
+    ringPut(trailer, sizeof(trailer));
+}
+
+void initTelemetry() {
+    if (USE_BINARY_TELEMETRY) Serial.setTxBufferSize(SERIAL_TX_BUFFER_BYTES);
+}
+
+void telemetryPump() {
+    while (ringHead != ringTail) {
+        int room = Serial.availableForWrite();
+        if (room <= 0) return;
+
+        uint32_t offset = ringTail & (TELEMETRY_RING_BYTES - 1);
+        uint32_t chunk = ringHead - ringTail;
+        if (chunk > TELEMETRY_RING_BYTES - offset) chunk = TELEMETRY_RING_BYTES - offset;   // up to the wrap
+        if (chunk > (uint32_t)room) chunk = (uint32_t)room;
+
+        ringTail += (uint32_t)Serial.write(ring + offset, chunk);
+    }
+}
+
+void telemetryFlush() {
+    for (;;) {
+        telemetryPump();
+        if (ringHead == ringTail) break;
+        delay(1);
+    }
+    Serial.flush();
+}
+
+uint32_t telemetryDropped() {
+    return droppedPackets;
+}
+
+/* ---------------- CONSOLE ---------------- */
+
+static char     lineBuf[TELEMETRY_MAX_PAYLOAD];
+static uint32_t lineLen = 0;
+
+static void flushLine() {
+    sendPacket(TELEM_TEXT, lineBuf, (uint8_t)lineLen);
+    lineLen = 0;
+}
+
+static void consoleWrite(const char *s) {
+    if (!USE_BINARY_TELEMETRY) {
+        Serial.print(s);
+        return;
+    }
+    for (; *s != '\0'; ++s) {
+        if (*s == '\n') {
+            flushLine();
+        } else {
+            lineBuf[lineLen++] = *s;
+            if (lineLen == sizeof(lineBuf)) flushLine();
+        }
+    }
+}
+
+void consolePrintf(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    consoleWrite(buf);
+}
+
+void consolePrintln(const char *s) {
+    consoleWrite(s);
+    consoleWrite("\n");
+}
+
+/* ---------------- RECORDS ---------------- */
+
+static uint16_t sat16(uint64_t v) {
+    return (v > 0xFFFF) ? 0xFFFF : (uint16_t)v;
+}
+
+void telemetrySession() {
+    if (!USE_BINARY_TELEMETRY) return;
+    const SessionSegment &first = activeProgram().source->segments[0];
+    TelemetrySession s = {};
+    s.numLeds           = NUM_LEDS;
+    s.framePeriodUs     = FRAME_PERIOD_US;
+    s.leftHz            = first.leftHz;
+    s.rightHz           = first.rightHz;
+    s.rampInSeconds     = first.seconds;
+    s.maxSessionSeconds = sessionEndSeconds();
+    s.fixedPoint        = RENDER_FIXED_POINT;
+    s.dualCore          = USE_DUAL_CORE_PIPELINE;
+    sendPacket(TELEM_SESSION, &s, sizeof(s));
+}
+
+void telemetryFrame(const FrameTick &frame, const FrameParams &fp, uint64_t sessionUs, uint64_t endUs) {
+    if (!USE_BINARY_TELEMETRY) return;
+    TelemetryFrame f;
+    f.index          = frame.index;
+    f.sessionUs      = (uint32_t)sessionUs;
+    f.startLatencyUs = sat16(frame.startUs > frame.idealUs ? frame.startUs - frame.idealUs : 0);
+    f.frameUs        = sat16(endUs > frame.idealUs ? endUs - frame.idealUs : 0);
+    f.finalL         = (uint16_t)q15FromUnit(fp.finalL);
+    f.finalR         = (uint16_t)q15FromUnit(fp.finalR);
+    f.rampMul        = (uint16_t)q15FromUnit(fp.rampMul);
+    f.breathe        = (uint16_t)q15FromUnit(fp.breathe);
+    f.mandalaMode    = (uint8_t)fp.mandalaMode;
+    f.master         = (uint16_t)q15FromUnit(fp.master);
+    f.dropped        = (frame.dropped > 255) ? 255 : (uint8_t)frame.dropped;
+    sendPacket(TELEM_FRAME, &f, sizeof(f));
+}
+
+void telemetryStats(const SchedulerStats &st, uint32_t presentationOffsetUs) {
+    if (!USE_BINARY_TELEMETRY) return;
+    TelemetryStats s;
+    s.frames               = st.frames;
+    s.dropped              = st.dropped;
+    s.late                 = st.late;
+    s.maxStartLatencyUs    = st.maxStartLatencyUs;
+    s.maxFrameUs           = st.maxFrameUs;
+    s.presentationOffsetUs = presentationOffsetUs;
+    s.telemetryDropped     = droppedPackets;
+    sendPacket(TELEM_STATS, &s, sizeof(s));
+}
+
+void telemetryEvent(TelemetryEvent event, uint32_t value) {
+    if (!USE_BINARY_TELEMETRY) return;
+    TelemetryEventRecord e = {(uint8_t)event, value};
+    sendPacket(TELEM_EVENT, &e, sizeof(e));
+}
@@ -0,0 +1,64 @@
+/*
+    ================================================================
+                 TELEMETRY + CONSOLE OUTPUT (serial)
+    ================================================================
+
+    All serial output goes through here. Two modes, chosen by
+    BINARY_TELEMETRY in config.h:
+
+      text     consolePrintf() prints to Serial as before; no frame data.
+      binary   framed packets (telemetry_format.h): one TELEM_FRAME per
+               frame, session/stats/event records, and console lines as
+               TELEM_TEXT. Decode with tools/telemetry_decode.
+
+    Packets go into a RAM ring and are drained by telemetryPump(), which
+    writes only what the UART driver's TX buffer can take without
+    blocking. The UART interrupt moves bytes from that buffer into the
+    FIFO. A burst that doesn't fit in the ring is dropped whole and shows
+    up as a sequence gap; the render loop never waits on the wire.
+
+    At 100 FPS the frame stream is ~3.1 kB/s, a quarter of 115200 baud.
+
+    The ring is written and drained from the loop task only.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "render.h"
+#include "scheduler.h"
+#include "telemetry_format.h"
+
+/*
+    Size the UART TX buffer; call before Serial.begin().
+*/
+void initTelemetry();
+
+/*
+    Console text. Text mode: straight to Serial. Binary mode: buffered
+    until '\n', then sent as one TELEM_TEXT packet.
+*/
+void consolePrintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void consolePrintln(const char *s = "");
+
+/*
+    Binary mode only (no-ops in text mode).
+*/
+void telemetrySession();
+void telemetryFrame(const FrameTick &frame, const FrameParams &fp, uint64_t sessionUs, uint64_t endUs);
+void telemetryStats(const SchedulerStats &st, uint32_t presentationOffsetUs);
+void telemetryEvent(TelemetryEvent event, uint32_t value);
+
+/*
+    Move queued bytes to the UART without blocking. Call once per frame.
+*/
+void telemetryPump();
+
+/*
+    Drain everything, blocking; for shutdown paths only.
+*/
+void telemetryFlush();
+
+// Packets dropped on a full ring since boot
+uint32_t telemetryDropped();
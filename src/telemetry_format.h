@@ -0,0 +1,115 @@
+/*
+    ================================================================
+                    BINARY TELEMETRY WIRE FORMAT
+    ================================================================
+
+    Shared by the firmware (telemetry.h) and the host decoder
+    (tools/telemetry_decoder.h). Little-endian, packed:
+
+        0xA5 0x5A           sync
+        uint8_t  type       TelemetryType
+        uint8_t  len        payload bytes
+        uint16_t seq        per-packet sequence number, wraps
+        payload[len]
+        uint16_t crc        CRC-16/CCITT-FALSE over type .. payload
+
+    Every packet the firmware tries to send takes a sequence number, so
+    packets dropped on a full ring show up as gaps. A decoder that loses
+    sync scans for the next sync word whose CRC checks out.
+
+    Fixed-point fields are Q15 (32768 = 1.0) in uint16_t.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint8_t TELEMETRY_SYNC0 = 0xA5;
+constexpr uint8_t TELEMETRY_SYNC1 = 0x5A;
+constexpr int     TELEMETRY_HEADER_BYTES = 6;   // sync, type, len, seq
+constexpr int     TELEMETRY_CRC_BYTES    = 2;
+constexpr int     TELEMETRY_MAX_PAYLOAD  = 255;
+
+enum TelemetryType : uint8_t {
+    TELEM_FRAME   = 1,   // TelemetryFrame, once per rendered frame
+    TELEM_TEXT    = 2,   // one console line, no terminator
+    TELEM_SESSION = 3,   // TelemetrySession, at boot
+    TELEM_STATS   = 4,   // TelemetryStats, every STATS_REPORT_SECONDS
+    TELEM_EVENT   = 5,   // TelemetryEventRecord
+};
+
+enum TelemetryEvent : uint8_t {
+    TELEM_EVENT_PANIC       = 1,   // value: press-to-dark latency μs (0 = not confirmed)
+    TELEM_EVENT_SESSION_END = 2,   // value: session time, ms
+    TELEM_EVENT_UNDERRUN    = 3,   // frame stream ran dry; value: session time, ms
+};
+
+struct __attribute__((packed)) TelemetryFrame {
+    uint32_t index;            // deadline number since session start
+    uint32_t sessionUs;        // time the frame was rendered for
+    uint16_t startLatencyUs;   // wake-up - ideal deadline (saturated)
+    uint16_t frameUs;          // endFrame - ideal deadline (saturated)
+    uint16_t finalL;           // Q15
+    uint16_t finalR;           // Q15
+    uint16_t rampMul;          // Q15
+    uint16_t breathe;          // Q15
+    uint16_t master;           // Q15 output level
+    uint8_t  mandalaMode;
+    uint8_t  dropped;          // deadlines skipped before this frame (saturated)
+};
+
+struct __attribute__((packed)) TelemetrySession {
+    uint16_t numLeds;
+    uint32_t framePeriodUs;
+    float    leftHz;           // first program segment
+    float    rightHz;
+    float    rampInSeconds;    // length of the first segment
+    float    maxSessionSeconds;
+    uint8_t  fixedPoint;       // RENDER_FIXED_POINT
+    uint8_t  dualCore;         // USE_DUAL_CORE_PIPELINE
+};
+
+struct __attribute__((packed)) TelemetryStats {
+    uint32_t frames;
+    uint32_t dropped;
+    uint32_t late;
+    uint32_t maxStartLatencyUs;
+    uint32_t maxFrameUs;
+    uint32_t presentationOffsetUs;
+    uint32_t telemetryDropped;   // packets lost to a full ring
+};
+
+struct __attribute__((packed)) TelemetryEventRecord {
+    uint8_t  event;            // TelemetryEvent
+    uint32_t value;
+};
+
+static_assert(sizeof(TelemetryFrame) == 24, "telemetry frame layout");
+static_assert(sizeof(TelemetrySession) == 24, "telemetry session layout");
+
+/* ---------------- CRC-16/CCITT-FALSE ---------------- */
+
+// Poly 0x1021, init 0xFFFF, no reflection; table generated at compile time.
+struct Crc16Table {
+    uint16_t v[256];
+    constexpr Crc16Table() : v() {
+        for (int k = 0; k < 256; ++k) {
+            uint16_t crc = (uint16_t)(k << 8);
+            for (int b = 0; b < 8; ++b) {
+                crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+            }
+            v[k] = crc;
+        }
+    }
+};
+
+constexpr Crc16Table CRC16_TABLE;
+
+inline uint16_t crc16Update(uint16_t crc, const uint8_t *data, int len) {
+    for (int i = 0; i < len; ++i) {
+        crc = (uint16_t)((crc << 8) ^ CRC16_TABLE.v[(uint8_t)((crc >> 8) ^ data[i])]);
+    }
+    return crc;
+}
+
+constexpr uint16_t CRC16_INIT = 0xFFFF;
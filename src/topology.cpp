@@ -0,0 +1,136 @@
+#include "topology.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+static_assert(layoutLeds(ACTIVE_LAYOUT) == NUM_LEDS, "LED_LAYOUT does not describe NUM_LEDS LEDs");
+static_assert(layoutStripLeds(ACTIVE_LAYOUT) == NUM_LEDS, "LED_LAYOUT's strips do not add up to NUM_LEDS");
+
+/* ---------------- TABLE BUILDER ---------------- */
+
+// Normalised LED position rank / NUM_LEDS as Q0.32 turns
+constexpr uint32_t LED_POS_STEP_Q32 = (uint32_t)(4294967296ULL / NUM_LEDS);
+
+// Radii are normalised per group: each eye, and EYE_BY_RANK on its own
+enum : uint8_t { GROUP_LEFT, GROUP_RIGHT, GROUP_BY_RANK, GROUP_COUNT };
+
+// Per-LED scratch, in physical order
+struct Placement {
+    double   x, y;       // relative to the centre of the LED's eye
+    uint8_t  group;
+    uint16_t ordinal;    // wiring order within the group
+    bool     hasAngle;   // false on strips
+    uint32_t angleQ32;
+};
+
+static Placement placements[NUM_LEDS];
+
+static uint8_t groupOf(EyeAssign eye, double x) {
+    if (eye == EYE_LEFT)  return GROUP_LEFT;
+    if (eye == EYE_RIGHT) return GROUP_RIGHT;
+    if (eye == EYE_BY_RANK) return GROUP_BY_RANK;
+    return (x < 0.0) ? GROUP_LEFT : GROUP_RIGHT;
+}
+
+static uint32_t turnsQ32(double turns) {
+    turns -= floor(turns);
+    return (uint32_t)(uint64_t)llround(turns * 4294967296.0);
+}
+
+// Segment-local positions in LED pitches (ring radius units for rings)
+static void placeSegment(const LayoutSegment &seg, int first) {
+    for (int k = 0; k < seg.count; ++k) {
+        Placement &p = placements[first + k];
+        p.hasAngle = true;
+        if (seg.shape == SHAPE_STRIP) {
+            p.x = k + 0.5 - seg.count * 0.5;
+            p.y = 0.0;
+            p.hasAngle = false;
+        } else if (seg.shape == SHAPE_RING) {
+            double turns = (double)k / seg.count;
+            p.x = seg.radius * cos(turns * 2.0 * M_PI);
+            p.y = seg.radius * sin(turns * 2.0 * M_PI);
+            p.angleQ32 = (uint32_t)(((uint64_t)k << 32) / seg.count);
+        } else {
+            int row = k / seg.width;
+            int col = (row & 1) ? seg.width - 1 - k % seg.width : k % seg.width;
+            int rows = seg.count / seg.width;
+            p.x = col + 0.5 - seg.width * 0.5;
+            p.y = rows * 0.5 - row - 0.5;   // up is positive
+        }
+        p.group = groupOf(seg.eye, p.x);
+
+        // Each half of a split segment is centred on its own
+        if (seg.eye == EYE_BY_SIDE) {
+            int half = (seg.shape == SHAPE_MATRIX) ? seg.width / 2 : seg.count / 2;
+            p.x += (p.x < 0.0) ? half * 0.5 : -half * 0.5;
+        }
+        if (p.hasAngle && seg.shape != SHAPE_RING) {
+            p.angleQ32 = (p.x == 0.0 && p.y == 0.0) ? 0 : turnsQ32(atan2(p.y, p.x) / (2.0 * M_PI));
+        }
+    }
+}
+
+static void buildTopology(const LedLayout &layout, Topology &t) {
+    t.name = layout.name;
+
+    int first = 0;
+    for (int s = 0; s < layout.count; ++s) {
+        placeSegment(layout.segments[s], first);
+        first += layout.segments[s].count;
+    }
+
+    // Normalise radii to the outermost LED of each group
+    double maxRadius[GROUP_COUNT] = {};
+    uint16_t ordinals[GROUP_COUNT] = {};
+    static double radius[NUM_LEDS];
+    for (int i = 0; i < NUM_LEDS; ++i) {
+        Placement &p = placements[i];
+        radius[i] = sqrt(p.x * p.x + p.y * p.y);
+        p.ordinal = ordinals[p.group]++;
+        if (radius[i] > maxRadius[p.group]) maxRadius[p.group] = radius[i];
+    }
+    for (int i = 0; i < NUM_LEDS; ++i) {
+        double m = maxRadius[placements[i].group];
+        radius[i] = (m > 0.0) ? radius[i] / m : 0.0;
+    }
+
+    // Spiral order: centre-out, equal radii interleaved across the eyes
+    // in wiring order
+    for (int i = 0; i < NUM_LEDS; ++i) t.led[i] = (uint16_t)i;
+    std::sort(t.led, t.led + NUM_LEDS, [](uint16_t a, uint16_t b) {
+        if (radius[a] != radius[b]) return radius[a] < radius[b];
+        if (placements[a].ordinal != placements[b].ordinal) return placements[a].ordinal < placements[b].ordinal;
+        return placements[a].group < placements[b].group;
+    });
+
+    for (int r = 0; r < NUM_LEDS; ++r) {
+        const uint16_t i = t.led[r];
+        const Placement &p = placements[i];
+        t.rankOf[i] = (uint16_t)r;
+        t.radius[r] = (float)radius[i];
+        t.angle[r]  = p.hasAngle ? (float)((double)p.angleQ32 / 4294967296.0) : (p.x < 0.0 ? 0.5f : 0.0f);
+        t.eye[r]    = (p.group == GROUP_BY_RANK) ? (r >= NUM_LEDS / 2) : (p.group == GROUP_RIGHT);
+
+        t.spiralQ32[r] = (uint32_t)r * LED_POS_STEP_Q32;
+        t.spiral[r]    = (float)r / (float)NUM_LEDS;
+        t.petalQ32[r]  = p.hasAngle ? p.angleQ32 : t.spiralQ32[r];
+        t.petal[r]     = p.hasAngle ? t.angle[r] : t.spiral[r];
+
+        // The body repaints its own LEDs, so reflections only show on the edge
+        int source = r - REFLECTION_OFFSET;
+        bool edge = r >= NUM_LEDS - EDGE_LEDS;
+        t.echo[r] = (edge && source >= ANCHOR_LEDS && source < NUM_LEDS - EDGE_LEDS) ? (int16_t)source : -1;
+    }
+}
+
+const Topology &topology() {
+    // Offline renderers call this from several threads at once
+    static const Topology *table = [] {
+        static Topology t;
+        buildTopology(ACTIVE_LAYOUT, t);
+        return &t;
+    }();
+    return *table;
+}
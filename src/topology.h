@@ -0,0 +1,168 @@
+/*
+    ================================================================
+                            LED TOPOLOGY
+    ================================================================
+
+    Where every LED sits. A layout is a list of segments in wiring order
+    (a straight strip, a ring, a serpentine matrix), each belonging to an
+    eye, and a split of the physical LEDs into output strips that are
+    driven in parallel (led_output.h). LED_LAYOUT in config.h picks one
+    of the built-in layouts.
+
+    On first use topology() turns the layout into a structure-of-arrays
+    table in spiral order: LEDs sorted centre-out by radius, equal radii
+    alternating between the eyes. The renderer never looks at the layout
+    again. Each frame it walks three rank ranges:
+
+      [0, ANCHOR_LEDS)                  centre anchors
+      [ANCHOR_LEDS, count - EDGE_LEDS)  body, one mask kernel per mode
+      [count - EDGE_LEDS, count)        edge core, plus the reflection
+                                        of the body LED REFLECTION_OFFSET
+                                        ranks inward
+
+    The original 20-LED strip is layout 0 and renders exactly as before.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+
+/* ---------------- LAYOUT DESCRIPTION ---------------- */
+
+enum LayoutShape : uint8_t {
+    SHAPE_STRIP,    // straight line, centred on its middle
+    SHAPE_RING,     // `count` LEDs counterclockwise from 3 o'clock
+    SHAPE_MATRIX,   // `width` columns, serpentine rows from the top left
+};
+
+enum EyeAssign : uint8_t {
+    EYE_LEFT,
+    EYE_RIGHT,
+    EYE_BY_RANK,    // inner half of the spiral order left (the original strip)
+    EYE_BY_SIDE,    // left half of the columns left, each half centred on its own
+};
+
+struct LayoutSegment {
+    LayoutShape shape;
+    EyeAssign   eye;
+    uint16_t    count;    // LEDs in the segment
+    uint16_t    width;    // SHAPE_MATRIX only
+    float       radius;   // SHAPE_RING only, any unit shared by the eye's rings
+};
+
+struct LedLayout {
+    const char          *name;
+    const LayoutSegment *segments;
+    uint8_t              count;
+    const uint16_t      *strips;       // LEDs per output strip, in physical order
+    uint8_t              stripCount;   // one LED_STRIP_PINS entry each
+};
+
+/* ---------------- BUILT-IN LAYOUTS ---------------- */
+
+// The original: one strip, wound so the spiral runs 9,10,8,11,...,0,19
+constexpr LayoutSegment SPIRAL_STRIP[] = {
+    { SHAPE_STRIP, EYE_BY_RANK, NUM_LEDS, 0, 0.0f },
+};
+constexpr uint16_t SPIRAL_STRIP_OUT[] = { NUM_LEDS };
+
+// Goggles from stacked 1/8/12/16/24 rings, one stack and strip per eye
+constexpr LayoutSegment RING_GOGGLES[] = {
+    { SHAPE_RING, EYE_LEFT,   1, 0, 0.0f },
+    { SHAPE_RING, EYE_LEFT,   8, 0, 1.0f },
+    { SHAPE_RING, EYE_LEFT,  12, 0, 2.0f },
+    { SHAPE_RING, EYE_LEFT,  16, 0, 3.0f },
+    { SHAPE_RING, EYE_LEFT,  24, 0, 4.0f },
+    { SHAPE_RING, EYE_RIGHT,  1, 0, 0.0f },
+    { SHAPE_RING, EYE_RIGHT,  8, 0, 1.0f },
+    { SHAPE_RING, EYE_RIGHT, 12, 0, 2.0f },
+    { SHAPE_RING, EYE_RIGHT, 16, 0, 3.0f },
+    { SHAPE_RING, EYE_RIGHT, 24, 0, 4.0f },
+};
+constexpr uint16_t RING_GOGGLES_OUT[] = { 61, 61 };
+
+// One 16x16 panel across both eyes, fed as four 4-row bands
+constexpr LayoutSegment PANEL_16X16[] = {
+    { SHAPE_MATRIX, EYE_BY_SIDE, 256, 16, 0.0f },
+};
+constexpr uint16_t PANEL_16X16_OUT[] = { 64, 64, 64, 64 };
+
+#define LAYOUT(name, segments, strips) \
+    { name, segments, sizeof(segments) / sizeof(segments[0]), strips, sizeof(strips) / sizeof(strips[0]) }
+
+// Indexed by LED_LAYOUT
+constexpr LedLayout LED_LAYOUTS[] = {
+    LAYOUT("spiral strip", SPIRAL_STRIP, SPIRAL_STRIP_OUT),
+    LAYOUT("ring goggles", RING_GOGGLES, RING_GOGGLES_OUT),
+    LAYOUT("16x16 panel", PANEL_16X16, PANEL_16X16_OUT),
+};
+constexpr int LED_LAYOUT_COUNT = sizeof(LED_LAYOUTS) / sizeof(LED_LAYOUTS[0]);
+
+#undef LAYOUT
+
+static_assert(LED_LAYOUT >= 0 && LED_LAYOUT < LED_LAYOUT_COUNT, "no such LED_LAYOUT");
+constexpr LedLayout ACTIVE_LAYOUT = LED_LAYOUTS[LED_LAYOUT];
+
+// LEDs the layout describes, or -1 if a segment is malformed
+constexpr int layoutLeds(const LedLayout &layout) {
+    int n = 0;
+    for (int s = 0; s < layout.count; ++s) {
+        const LayoutSegment &seg = layout.segments[s];
+        if (seg.count == 0) return -1;
+        if (seg.shape == SHAPE_MATRIX && (seg.width == 0 || seg.count % seg.width != 0)) return -1;
+        if (seg.eye == EYE_BY_SIDE && (seg.shape == SHAPE_RING || (seg.shape == SHAPE_MATRIX && seg.width % 2 != 0))) {
+            return -1;
+        }
+        n += seg.count;
+    }
+    return n;
+}
+
+// LEDs the layout's output strips cover, or -1 if there are too many strips
+constexpr int layoutStripLeds(const LedLayout &layout) {
+    if (layout.stripCount == 0 || layout.stripCount > MAX_LED_STRIPS) return -1;
+    int n = 0;
+    for (int s = 0; s < layout.stripCount; ++s) n += layout.strips[s];
+    return n;
+}
+
+// One show() lasts as long as the longest strip takes to shift out
+constexpr int longestStrip(const LedLayout &layout) {
+    int n = 0;
+    for (int s = 0; s < layout.stripCount; ++s) n = (layout.strips[s] > n) ? layout.strips[s] : n;
+    return n;
+}
+
+/* ---------------- PRECOMPUTED TABLE ---------------- */
+
+constexpr int ANCHOR_LEDS = 2;
+constexpr int EDGE_LEDS   = 2;
+
+static_assert(NUM_LEDS >= 2 * (ANCHOR_LEDS + EDGE_LEDS), "too few LEDs for anchors, body and edge");
+
+/*
+    Every column is indexed by spiral rank. `spiral` is the mask
+    coordinate along the spiral (rank / NUM_LEDS); `petal` is the radial
+    mask's: the angle on rings and matrices, the spiral position on a
+    strip, which has no angle. Q0.32 copies feed the Q15 path.
+*/
+struct Topology {
+    const char *name;
+
+    uint16_t led[NUM_LEDS];        // physical index
+    float    radius[NUM_LEDS];     // 0 at the eye's centre, 1 at its outermost LED
+    float    angle[NUM_LEDS];      // turns, 0..1
+    uint8_t  eye[NUM_LEDS];        // 0 left, 1 right
+    float    spiral[NUM_LEDS];
+    float    petal[NUM_LEDS];
+    uint32_t spiralQ32[NUM_LEDS];
+    uint32_t petalQ32[NUM_LEDS];
+    int16_t  echo[NUM_LEDS];       // rank whose reflection this LED shows, -1 none
+
+    uint16_t rankOf[NUM_LEDS];     // physical index -> spiral rank
+};
+
+// Table for LED_LAYOUT, built on the first call
+const Topology &topology();
@@ -0,0 +1,46 @@
+#include "trig.h"
+#include "cycles.h"
+
+namespace {
+
+constexpr int ACCURACY_SAMPLES = 8192;
+constexpr int TIMING_CALLS     = 1024;
+
+volatile float trigSink = 0.0f;   // keeps timed calls from being optimised away
+
+}  // namespace
+
+TrigReport measureTrigBackend() {
+    TrigReport report = {};
+
+    for (int k = 0; k < ACCURACY_SAMPLES; ++k) {
+        float turns = (float)k / (float)ACCURACY_SAMPLES;
+        float err = fabsf(sinTurns(turns) - sinf(6.28318530717958647692f * turns));
+        if (err > report.sinMaxError) report.sinMaxError = err;
+
+        float x = EXP_LUT_RANGE * turns;
+        err = fabsf(expNeg(x) - expf(-x));
+        if (err > report.expMaxError) report.expMaxError = err;
+    }
+
+    // Timing: same inputs for both paths, average over TIMING_CALLS.
+    const float step = 1.0f / (float)TIMING_CALLS;
+    float acc = 0.0f;
+
+    uint32_t c0 = readCycleCounter();
+    for (int k = 0; k < TIMING_CALLS; ++k) acc += sinf(6.28318530717958647692f * (k * step));
+    uint32_t c1 = readCycleCounter();
+    for (int k = 0; k < TIMING_CALLS; ++k) acc += sinTurns(k * step);
+    uint32_t c2 = readCycleCounter();
+    for (int k = 0; k < TIMING_CALLS; ++k) acc += expf(-2.5f * (k * step));
+    uint32_t c3 = readCycleCounter();
+    for (int k = 0; k < TIMING_CALLS; ++k) acc += expNeg(2.5f * (k * step));
+    uint32_t c4 = readCycleCounter();
+    trigSink = acc;
+
+    report.sinCyclesRef    = (c1 - c0) / TIMING_CALLS;
+    report.sinCyclesActive = (c2 - c1) / TIMING_CALLS;
+    report.expCyclesRef    = (c3 - c2) / TIMING_CALLS;
+    report.expCyclesActive = (c4 - c3) / TIMING_CALLS;
+    return report;
+}
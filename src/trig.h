@@ -0,0 +1,159 @@
+/*
+    ================================================================
+                    TRIG BACKEND (float or Q15 tables)
+    ================================================================
+
+    All render-path trig goes through sinTurns()/expNeg()/wrapTurns().
+    The backend is chosen at compile time:
+
+      TRIG_USE_LUT = 1   Q15 sine table (512 entries) and exp(-x) table
+                         (512 entries over 0..8), both generated constexpr
+                         at compile time, linearly interpolated.
+      TRIG_USE_LUT = 0   sinf()/expf() reference path.
+
+    Max abs error of the LUT path is ~6e-5 (sine) and ~4e-5 (exp), far below
+    one 8-bit output step (3.9e-3). measureTrigBackend() reports the exact
+    figures and call cost on the running machine.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+#ifndef TRIG_USE_LUT
+#define TRIG_USE_LUT 1
+#endif
+
+/* ---------------- COMPILE-TIME TABLE GENERATION ---------------- */
+
+constexpr int    SIN_LUT_BITS = 9;
+constexpr int    SIN_LUT_SIZE = 1 << SIN_LUT_BITS;
+constexpr int    EXP_LUT_SIZE = 512;
+constexpr float  EXP_LUT_RANGE = 8.0f;   // exp(-x) tabulated for x in [0, 8)
+constexpr double TRIG_PI = 3.14159265358979323846;
+
+// Taylor-series sin for table generation only (|x| <= pi after reduction).
+constexpr double constexprSin(double x) {
+    while (x > TRIG_PI)  x -= 2.0 * TRIG_PI;
+    while (x < -TRIG_PI) x += 2.0 * TRIG_PI;
+    double term = x, sum = x;
+    for (int n = 1; n < 20; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constexprExp(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 40; ++n) {
+        term *= x / n;
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr int16_t toQ15(double v) {
+    return (int16_t)(v >= 0.0 ? v * 32767.0 + 0.5 : v * 32767.0 - 0.5);
+}
+
+// One full turn plus a guard entry so interpolation never wraps.
+struct SinTableQ15 {
+    int16_t v[SIN_LUT_SIZE + 1];
+    constexpr SinTableQ15() : v() {
+        for (int k = 0; k <= SIN_LUT_SIZE; ++k) {
+            v[k] = toQ15(constexprSin(2.0 * TRIG_PI * k / SIN_LUT_SIZE));
+        }
+    }
+};
+
+// exp(-x) for x in [0, EXP_LUT_RANGE], plus guard entry.
+struct ExpTableQ15 {
+    int16_t v[EXP_LUT_SIZE + 1];
+    constexpr ExpTableQ15() : v() {
+        for (int k = 0; k <= EXP_LUT_SIZE; ++k) {
+            v[k] = toQ15(1.0 / constexprExp((double)EXP_LUT_RANGE * k / EXP_LUT_SIZE));
+        }
+    }
+};
+
+constexpr SinTableQ15 SIN_LUT{};
+constexpr ExpTableQ15 EXP_LUT{};
+
+/* ---------------- FIXED-POINT KERNELS ---------------- */
+
+/*
+    Sine of a Q0.32 phase (2^32 == one turn), Q15 result.
+*/
+inline int16_t sinQ15(uint32_t phaseQ32) {
+    uint32_t idx  = phaseQ32 >> (32 - SIN_LUT_BITS);
+    int32_t  frac = (int32_t)((phaseQ32 >> (16 - SIN_LUT_BITS)) & 0xFFFF);
+    int32_t  a = SIN_LUT.v[idx];
+    int32_t  b = SIN_LUT.v[idx + 1];
+    return (int16_t)(a + (((b - a) * frac) >> 16));
+}
+
+/*
+    Float turns -> Q0.32 phase. Exact wrap for |turns| < 128.
+*/
+inline uint32_t turnsToQ32(float turns) {
+    return (uint32_t)(int32_t)(turns * 16777216.0f) << 8;
+}
+
+/* ---------------- BACKEND-SELECTED FLOAT API ---------------- */
+
+/*
+    sin(2π · turns)
+*/
+inline float sinTurns(float turns) {
+#if TRIG_USE_LUT
+    return (float)sinQ15(turnsToQ32(turns)) * (1.0f / 32767.0f);
+#else
+    return sinf(6.28318530717958647692f * turns);
+#endif
+}
+
+/*
+    exp(-x) for x >= 0. LUT path saturates to 0 beyond EXP_LUT_RANGE.
+    Negative x falls back to expf() on both paths.
+*/
+inline float expNeg(float x) {
+#if TRIG_USE_LUT
+    if (x < 0.0f) return expf(-x);
+    if (x >= EXP_LUT_RANGE) return 0.0f;
+    float   pos  = x * ((float)EXP_LUT_SIZE / EXP_LUT_RANGE);
+    int32_t idx  = (int32_t)pos;
+    float   frac = pos - (float)idx;
+    float   a = EXP_LUT.v[idx];
+    float   b = EXP_LUT.v[idx + 1];
+    return (a + (b - a) * frac) * (1.0f / 32767.0f);
+#else
+    return expf(-x);
+#endif
+}
+
+/*
+    Same result as fmodf(x, 1.0f) (keeps the sign of x) without the libm
+    call. Valid for |x| < 2^31.
+*/
+inline float wrapTurns(float x) {
+    return x - (float)(int32_t)x;
+}
+
+/* ---------------- ACCURACY / PERFORMANCE REPORT ---------------- */
+
+struct TrigReport {
+    float    sinMaxError;       // max |sinTurns - sinf| over one turn
+    float    expMaxError;       // max |expNeg - expf(-x)| over the table range
+    uint32_t sinCyclesRef;      // cycles per call, sinf reference
+    uint32_t sinCyclesActive;   // cycles per call, selected backend
+    uint32_t expCyclesRef;
+    uint32_t expCyclesActive;
+};
+
+/*
+    Sweep the active backend against libm and time both. Takes a few ms;
+    intended for boot diagnostics or host runs, not the frame loop.
+*/
+TrigReport measureTrigBackend();
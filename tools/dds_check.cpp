@@ -0,0 +1,120 @@
+/*
+    ================================================================
+                  DDS PHASE ACCUMULATION CHECK (host)
+    ================================================================
+
+    Runs every oscillator frequency the config uses (and the band edges)
+    for 24 simulated hours, advancing frame by frame with advanceTo() as
+    the render loop does, and compares the accumulated phase at every
+    frame against the closed form:
+
+      constant frequency   seek(t): inc * t, wrapped to one turn
+      linear chirp         inc * n + chirp * n(n-1)/2, evaluated in
+                           128-bit arithmetic
+
+    Frame times are the deadlines plus a pseudo-random start latency of
+    up to MAX_JITTER_US, so the steps are uneven the way they are on the
+    device. The phase must match bit for bit: any accumulated error at
+    all fails the run.
+
+    Usage: dds_check [hours]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "dds.h"
+
+constexpr uint32_t MAX_JITTER_US = 500;
+
+struct Case {
+    const char *name;
+    double      hz;
+    double      chirpHzPerS;   // 0 = constant frequency
+};
+
+static const Case CASES[] = {
+    {"left eye",         LEFT_FREQ_HZ,       0.0},
+    {"right eye",        RIGHT_FREQ_HZ,      0.0},
+    {"carrier",          CARRIER_FREQ_HZ,    0.0},
+    {"breath",           BREATH_FREQ_HZ,     0.0},
+    {"micro",            MICRO_FREQ_HZ,      0.0},
+    {"spiral left",      SPIRAL_LEFT_SPEED,  0.0},
+    {"spiral right",     SPIRAL_RIGHT_SPEED, 0.0},
+    {"spiral body",      SPIRAL_BODY_SPEED,  0.0},
+    {"band low",         MIN_FREQ_HZ,        0.0},
+    {"band high",        MAX_FREQ_HZ,        0.0},
+    {"chirp down",       MAX_FREQ_HZ,        -2.0 / 1200.0},
+    {"chirp up",         MIN_FREQ_HZ,        4.0 / 86400.0},
+};
+
+constexpr int CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+static int64_t chirpPerUs(double hzPerS) {
+    return (int64_t)(hzPerS * 1e-6 * DDS_TURNS_PER_US_AT_1HZ);
+}
+
+// Closed-form phase at `us` from phase 0 at t = 0
+static uint64_t expectedPhase(uint64_t inc, int64_t chirp, uint64_t us) {
+    if (chirp == 0) {
+        Oscillator ref;
+        ref.incPerUs = inc;
+        ref.seek(us);
+        return ref.phase;
+    }
+    unsigned __int128 n = us;
+    unsigned __int128 tri = n * (n - 1) / 2;
+    return (uint64_t)((unsigned __int128)inc * n + (unsigned __int128)(uint64_t)chirp * tri);
+}
+
+int main(int argc, char **argv) {
+    double hours = (argc > 1) ? atof(argv[1]) : 24.0;
+    uint64_t frames = (uint64_t)(hours * 3600.0 * 1e6 / FRAME_PERIOD_US);
+    if (frames == 0) {
+        fprintf(stderr, "usage: dds_check [hours]\n");
+        return 2;
+    }
+
+    Oscillator osc[CASE_COUNT];
+    uint64_t inc[CASE_COUNT];
+    uint64_t mismatches[CASE_COUNT] = {};
+    uint64_t firstBad[CASE_COUNT] = {};
+    for (int c = 0; c < CASE_COUNT; ++c) {
+        osc[c].setFrequency(CASES[c].hz);
+        osc[c].chirpPerUs = chirpPerUs(CASES[c].chirpHzPerS);
+        osc[c].seek(0);
+        inc[c] = osc[c].incPerUs;
+    }
+
+    uint32_t rng = 12345;
+    uint64_t us = 0;
+    for (uint64_t f = 1; f <= frames; ++f) {
+        rng = rng * 1664525u + 1013904223u;
+        us = f * FRAME_PERIOD_US + (rng >> 8) % MAX_JITTER_US;
+        for (int c = 0; c < CASE_COUNT; ++c) {
+            osc[c].advanceTo(us);
+            if (osc[c].phase != expectedPhase(inc[c], osc[c].chirpPerUs, us)) {
+                if (mismatches[c]++ == 0) firstBad[c] = f;
+            }
+        }
+    }
+
+    printf("%llu frames (%.1f h) per oscillator, advanceTo() vs closed form\n",
+           (unsigned long long)frames, (double)us / 3.6e9);
+    bool ok = true;
+    for (int c = 0; c < CASE_COUNT; ++c) {
+        printf("  %-16s %9.4f Hz", CASES[c].name, CASES[c].hz);
+        if (CASES[c].chirpHzPerS != 0.0) printf(" %+.2e Hz/s", CASES[c].chirpHzPerS);
+        else                             printf("%14s", "");
+        if (mismatches[c] == 0) {
+            printf("  exact\n");
+        } else {
+            printf("  FAIL: %llu frames differ, first at frame %llu\n",
+                   (unsigned long long)mismatches[c], (unsigned long long)firstBad[c]);
+            ok = false;
+        }
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
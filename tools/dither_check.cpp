@@ -0,0 +1,283 @@
+/*
+    ================================================================
+                TEMPORAL DITHER CHECK (host, or any target)
+    ================================================================
+
+    Renders the session frame by frame, exactly as loop() would with no
+    jitter, and sends every frame through both output paths:
+
+      plain    applyOutputCurve(), truncation (scale8() for a linear LED)
+      dither   TemporalDither (dither.h), what ledOutputShow() sends
+
+    The error of a path is the drive it sends minus the 16-bit drive
+    level it was asked for (gamma.h), as Rec.709 luminance averaged over
+    each eye, 0..255. It is recorded over the ramp-in and over the
+    fade-out, where levels crawl near black, and Welch-averaged (Hann,
+    50 % overlap, mean removed).
+    Reported per window, eye and path, as RMS in milli-LSB:
+
+        total            all frequencies above DC
+        <4 / 4-8 / >8    below, inside and above the theta band (Hz)
+        hi%              share of the error power above 8 Hz
+        spur             strongest single bin inside the theta band
+
+    The run fails unless, in every window and eye, dithering cuts the
+    theta-band error by at least the gate (default 10 dB) and puts most
+    of its error power above 8 Hz. Render and brightness quantisation
+    upstream of the output stage are not part of the error.
+
+    Finally the cost of apply() at this build's NUM_LEDS, against the
+    frame period (build with -DNUM_LEDS=3000 for a large strip).
+
+    Usage: dither_check [-n fft] [-g min-theta-cut-dB]
+*/
+
+#include <FastLED.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "config.h"
+#include "cycles.h"
+#include "dither.h"
+#include "fft.h"
+#include "gamma.h"
+#include "presentation.h"
+#include "render.h"
+#include "session_program.h"
+#include "topology.h"
+
+constexpr double THETA_LOW_HZ  = 4.0;
+constexpr double THETA_HIGH_HZ = 8.0;
+constexpr double MIN_HIGH_SHARE = 0.5;   // dithered error power above the theta band
+constexpr double LUMA_R = 0.2126, LUMA_G = 0.7152, LUMA_B = 0.0722;
+
+enum OutputPath { PATH_PLAIN, PATH_DITHER, PATH_COUNT };
+static const char *const PATH_NAMES[PATH_COUNT] = {"plain", "dither"};
+static const char *const EYE_NAMES[2] = {"left", "right"};
+
+static uint64_t frameVisibleUs(uint64_t frame) {
+    uint64_t us = frame * FRAME_PERIOD_US;
+    if (USE_PRESENTATION_COMPENSATION) us += WIRE_PRESENTATION_US;
+    return us;
+}
+
+static double luma(const CRGB &c) {
+    return LUMA_R * c.r + LUMA_G * c.g + LUMA_B * c.b;
+}
+
+/* ---------------- ERROR CAPTURE ---------------- */
+
+struct CheckWindow {
+    const char        *name;
+    float              startS, endS;
+    std::vector<float> error[PATH_COUNT][2];   // [path][eye], one sample per frame
+};
+
+/*
+    Render the whole session once, dithering every frame so the residuals
+    carry over exactly as on the target, and record both paths' per-eye
+    error for frames inside the windows.
+*/
+static void captureErrors(std::vector<CheckWindow> &windows) {
+    const Topology &topo = topology();
+    int eyeLeds[2] = {0, 0};
+    for (int r = 0; r < NUM_LEDS; ++r) eyeLeds[topo.eye[r]]++;
+
+    OscillatorBank bank;
+    bank.init();
+    static TemporalDither dither;
+    static CRGB frame[NUM_LEDS], plain[NUM_LEDS], sent[NUM_LEDS];
+    const OutputCurve &curve = outputCurve();
+
+    for (uint64_t k = 0;; ++k) {
+        uint64_t us = frameVisibleUs(k);
+        float t = (float)us * 0.000001f;
+        if (sessionFinished(t)) break;
+
+        FrameParams fp = computeFrameParams(bank, us);
+        renderFrame(fp, frame);
+        uint32_t master = outputMaster(fp.master);
+        memcpy(sent, frame, sizeof(frame));
+        dither.apply(curve, sent, master);
+
+        CheckWindow *w = nullptr;
+        for (CheckWindow &c : windows) {
+            if (t >= c.startS && t < c.endS) w = &c;
+        }
+        if (w == nullptr) continue;
+
+        memcpy(plain, frame, sizeof(frame));
+        applyOutputCurve(curve, plain, master);
+
+        double gain = (double)master / (1ull << 24);
+        double err[PATH_COUNT][2] = {};
+        for (int i = 0; i < NUM_LEDS; ++i) {
+            int eye = topo.eye[topo.rankOf[i]];
+            double ideal = gain * (LUMA_R * curve.level[0][frame[i].r] + LUMA_G * curve.level[1][frame[i].g] +
+                                   LUMA_B * curve.level[2][frame[i].b]);
+            err[PATH_PLAIN][eye]  += luma(plain[i]) - ideal;
+            err[PATH_DITHER][eye] += luma(sent[i]) - ideal;
+        }
+        for (int p = 0; p < PATH_COUNT; ++p) {
+            for (int e = 0; e < 2; ++e) w->error[p][e].push_back((float)(err[p][e] / eyeLeds[e]));
+        }
+    }
+}
+
+/* ---------------- WELCH PSD ---------------- */
+
+// Mean-square per one-sided bin: Hann segments, 50 % overlap, mean removed
+static std::vector<double> welchPsd(const std::vector<float> &x, const FftPlan &plan) {
+    size_t n = plan.n;
+    std::vector<double> window(n), psd(n / 2 + 1, 0.0);
+    double w2 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        window[i] = 0.5 - 0.5 * cos(2.0 * M_PI * (double)i / (double)(n - 1));
+        w2 += window[i] * window[i];
+    }
+
+    std::vector<cplx> buf(n);
+    int segments = 0;
+    for (size_t start = 0; start + n <= x.size(); start += n / 2, ++segments) {
+        double mean = 0.0;
+        for (size_t i = 0; i < n; ++i) mean += x[start + i];
+        mean /= (double)n;
+        for (size_t i = 0; i < n; ++i) buf[i] = cplx((x[start + i] - mean) * window[i], 0.0);
+        plan.forward(buf.data());
+        for (size_t k = 0; k <= n / 2; ++k) psd[k] += std::norm(buf[k]);
+    }
+    for (size_t k = 1; k <= n / 2; ++k) psd[k] *= ((k < n / 2) ? 2.0 : 1.0) / ((double)n * w2 * segments);
+    psd[0] = 0.0;
+    return psd;
+}
+
+struct BandReport {
+    double total, low, theta, high;   // mean-square
+    double spur;                      // largest theta-band bin, mean-square
+};
+
+static BandReport bands(const std::vector<double> &psd, double binHz) {
+    BandReport r = {};
+    for (size_t k = 1; k < psd.size(); ++k) {
+        double hz = (double)k * binHz;
+        r.total += psd[k];
+        if (hz < THETA_LOW_HZ) {
+            r.low += psd[k];
+        } else if (hz <= THETA_HIGH_HZ) {
+            r.theta += psd[k];
+            r.spur = std::max(r.spur, psd[k]);
+        } else {
+            r.high += psd[k];
+        }
+    }
+    return r;
+}
+
+static double mlsb(double meanSquare) {
+    return 1000.0 * sqrt(meanSquare);
+}
+
+/* ---------------- COST ---------------- */
+
+// Median cycles of one apply() over a few hundred rendered frames
+static uint32_t ditherCycles() {
+    static TemporalDither dither;
+    static CRGB frame[NUM_LEDS];
+    OscillatorBank bank;
+    bank.init();
+    uint64_t us = (uint64_t)(RAMP_IN_SECONDS * 1e6f);
+    bank.seek(us);
+
+    std::vector<uint32_t> cycles;
+    for (int f = 0; f < 300; ++f, us += FRAME_PERIOD_US) {
+        renderFrame(computeFrameParams(bank, us), frame);
+        uint32_t c0 = readCycleCounter();
+        dither.apply(outputCurve(), frame, outputMaster(sessionLevel(0.0f)));
+        cycles.push_back(readCycleCounter() - c0);
+    }
+    std::nth_element(cycles.begin(), cycles.begin() + cycles.size() / 2, cycles.end());
+    return cycles[cycles.size() / 2];
+}
+
+/* ---------------- MAIN ---------------- */
+
+static void usage() {
+    fprintf(stderr, "usage: dither_check [-n fft] [-g min-theta-cut-dB]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    size_t fftSize = 1024;
+    double gateDb = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        if      (strcmp(argv[i], "-n") == 0) fftSize = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "-g") == 0) gateDb = atof(argv[++i]);
+        else usage();
+    }
+    if (fftSize < 64 || (fftSize & (fftSize - 1)) != 0) usage();
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        fprintf(stderr, "session program: %s\n", activeProgram().error);
+        return 1;
+    }
+
+    std::vector<CheckWindow> windows(2);
+    windows[0].name = "ramp-in";
+    windows[0].startS = 0.0f;
+    windows[0].endS = RAMP_IN_SECONDS;
+    windows[1].name = "fade-out";
+    windows[1].startS = sessionEndSeconds();
+    windows[1].endS = sessionEndSeconds() + FADE_OUT_SECONDS;
+    captureErrors(windows);
+
+    FftPlan plan;
+    plan.init(fftSize);
+    double binHz = 1e6 / (double)FRAME_PERIOD_US / (double)fftSize;
+
+    printf("%s, NUM_LEDS %d, level %.4f, %zu-point Welch (%.3f Hz/bin)\n", topology().name, NUM_LEDS,
+           sessionLevel(0.0f), fftSize, binHz);
+    printf("per-eye luminance error, RMS in milli-LSB; theta band %.0f-%.0f Hz\n\n", THETA_LOW_HZ,
+           THETA_HIGH_HZ);
+    printf("%-9s %-6s %-7s %8s %8s %8s %8s %6s %8s\n", "window", "eye", "path", "total", "<4", "4-8", ">8",
+           "hi%", "spur");
+
+    bool ok = true;
+    for (const CheckWindow &w : windows) {
+        size_t frames = w.error[0][0].size();
+        if (frames < fftSize) {
+            printf("%-9s only %zu frames, need %zu\n", w.name, frames, fftSize);
+            ok = false;
+            continue;
+        }
+        for (int e = 0; e < 2; ++e) {
+            BandReport r[PATH_COUNT];
+            for (int p = 0; p < PATH_COUNT; ++p) {
+                r[p] = bands(welchPsd(w.error[p][e], plan), binHz);
+                double share = r[p].total > 0.0 ? r[p].high / r[p].total : 1.0;
+                printf("%-9s %-6s %-7s %8.1f %8.1f %8.1f %8.1f %5.1f%% %8.1f\n", w.name, EYE_NAMES[e],
+                       PATH_NAMES[p], mlsb(r[p].total), mlsb(r[p].low), mlsb(r[p].theta), mlsb(r[p].high),
+                       100.0 * share, mlsb(r[p].spur));
+            }
+            const BandReport &plain = r[PATH_PLAIN], &dith = r[PATH_DITHER];
+            double cutDb = (dith.theta > 0.0 && plain.theta > 0.0) ? 10.0 * log10(plain.theta / dith.theta) : 99.0;
+            double share = dith.total > 0.0 ? dith.high / dith.total : 1.0;
+            bool pass = cutDb >= gateDb && share >= MIN_HIGH_SHARE;
+            printf("%-9s %-6s theta cut %.1f dB, %.0f%% above %.0f Hz: %s\n", w.name, EYE_NAMES[e], cutDb,
+                   100.0 * share, THETA_HIGH_HZ, pass ? "pass" : "FAIL");
+            ok = ok && pass;
+        }
+    }
+
+    uint32_t cycles = ditherCycles();
+    double us = (double)cycles * 1e6 / (double)cycleCounterHz();
+    printf("\napply(): %u cycles/frame (%.1f per LED), %.1f us = %.2f%% of the %u us frame period\n",
+           (unsigned)cycles, (double)cycles / NUM_LEDS, us, 100.0 * us / FRAME_PERIOD_US,
+           (unsigned)FRAME_PERIOD_US);
+    printf("%s\n", ok ? "pass" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+/*
+    ================================================================
+                  SESSION FADE-OUT CHECK (host, or any target)
+    ================================================================
+
+    Steps frame by frame through the fade-out, from sessionEndSeconds()
+    until sessionFinished(), and compares the output level per frame:
+
+      legacy   the old FastLED.setBrightness() fade: GLOBAL_BRIGHTNESS ·
+               fade² truncated to a brightness byte (kept here as the
+               reference)
+      master   sessionLevel() as the Q16 multiplier the output pass
+               applies per pixel (gamma.h)
+
+    For each it reports how many distinct levels the fade passes
+    through, the largest frame-to-frame step relative to the full
+    session level, and how long before the end the output is already
+    black. A full-white frame is also sent through the real output pass
+    (curve + temporal dither) every frame. Its emitted bytes, averaged
+    over TRACK_FRAMES frames, must follow the requested 16-bit drive
+    level to within TRACK_TOLERANCE_LSB.
+
+    The run fails unless the master fade never rises, passes through at
+    least MIN_LEVEL_GAIN times the legacy number of levels, has smaller
+    steps than the legacy fade, and the dithered output tracks it.
+
+    Usage: fade_check
+*/
+
+#include <FastLED.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <set>
+
+#include "config.h"
+#include "dither.h"
+#include "gamma.h"
+#include "presentation.h"
+#include "render.h"
+#include "session_program.h"
+
+constexpr int    MIN_LEVEL_GAIN      = 10;
+constexpr int    TRACK_FRAMES        = 10;     // 100 ms at 100 FPS
+constexpr double TRACK_TOLERANCE_LSB = 0.15;
+
+static uint64_t frameVisibleUs(uint64_t frame) {
+    uint64_t us = frame * FRAME_PERIOD_US;
+    if (USE_PRESENTATION_COMPENSATION) us += WIRE_PRESENTATION_US;
+    return us;
+}
+
+// The brightness byte the old fade handed to FastLED.setBrightness()
+static uint8_t legacyBrightness(float t) {
+    if (t <= sessionEndSeconds()) return GLOBAL_BRIGHTNESS;
+    float fade = clamp01(1.0f - (t - sessionEndSeconds()) / FADE_OUT_SECONDS);
+    return (uint8_t)(GLOBAL_BRIGHTNESS * fade * fade);
+}
+
+struct FadeStats {
+    std::set<uint32_t> levels;
+    double             maxStep = 0.0;     // fraction of the full session level
+    uint64_t           blackFrames = 0;   // frames already at zero
+    bool               monotonic = true;
+    uint32_t           last = 0;
+    bool               started = false;
+
+    void add(uint32_t level, uint32_t full) {
+        levels.insert(level);
+        if (started) {
+            if (level > last) monotonic = false;
+            double step = (double)(last > level ? last - level : level - last) / (double)full;
+            if (step > maxStep) maxStep = step;
+        }
+        if (level == 0) blackFrames++;
+        last = level;
+        started = true;
+    }
+};
+
+int main() {
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        fprintf(stderr, "session program: %s\n", activeProgram().error);
+        return 1;
+    }
+
+    // First frame visible after the end of the stimulus
+    uint64_t k = 0;
+    while ((float)frameVisibleUs(k) * 0.000001f <= sessionEndSeconds()) k++;
+
+    // Legacy levels as the scale8() multiplier (brightness + 1), 0 when black
+    FadeStats legacy, master;
+    const uint32_t legacyFull = GLOBAL_BRIGHTNESS + 1;
+    const uint32_t masterFull = outputMaster(sessionLevel(0.0f));
+
+    static TemporalDither dither;
+    static CRGB frame[NUM_LEDS];
+    const OutputCurve &curve = outputCurve();
+    double emitted = 0.0, requested = 0.0, maxTrackError = 0.0;
+    int window = 0;
+    uint64_t frames = 0;
+
+    for (;; ++k, ++frames) {
+        float t = (float)frameVisibleUs(k) * 0.000001f;
+        if (sessionFinished(t)) break;
+
+        uint8_t b = legacyBrightness(t);
+        legacy.add(b == 0 ? 0 : b + 1u, legacyFull);
+        uint32_t m = outputMaster(sessionLevel(t));
+        master.add(m, masterFull);
+
+        fill_solid(frame, NUM_LEDS, CRGB::White);
+        dither.apply(curve, frame, m);
+        emitted += frame[0].g;
+        requested += (double)curve.level[1][255] * m / (double)(1ull << 24);
+        if (++window == TRACK_FRAMES) {
+            double error = fabs(emitted - requested) / TRACK_FRAMES;
+            if (error > maxTrackError) maxTrackError = error;
+            emitted = requested = 0.0;
+            window = 0;
+        }
+    }
+
+    printf("fade-out: %llu frames (%.2f s) from %.1f s, full level %.4f\n", (unsigned long long)frames,
+           frames * FRAME_PERIOD_US / 1e6, sessionEndSeconds(), sessionLevel(0.0f));
+    printf("%-8s %8s %10s %12s %10s\n", "path", "levels", "max step", "black (s)", "monotonic");
+    const FadeStats *paths[2] = {&legacy, &master};
+    const char *names[2] = {"legacy", "master"};
+    for (int p = 0; p < 2; ++p) {
+        const FadeStats &s = *paths[p];
+        printf("%-8s %8zu %9.3f%% %12.2f %10s\n", names[p], s.levels.size(), 100.0 * s.maxStep,
+               s.blackFrames * FRAME_PERIOD_US / 1e6, s.monotonic ? "yes" : "NO");
+    }
+    printf("dithered output vs requested drive, %d-frame means: max error %.3f LSB\n", TRACK_FRAMES,
+           maxTrackError);
+
+    bool ok = master.monotonic && master.levels.size() >= MIN_LEVEL_GAIN * legacy.levels.size() &&
+              master.maxStep < legacy.maxStep && maxTrackError <= TRACK_TOLERANCE_LSB;
+    printf("%s\n", ok ? "pass" : "FAIL");
+    return ok ? 0 : 1;
+}
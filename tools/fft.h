@@ -0,0 +1,58 @@
+/*
+    ================================================================
+                  RADIX-2 FFT (host analysis tools)
+    ================================================================
+*/
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <complex>
+#include <utility>
+#include <vector>
+
+typedef std::complex<double> cplx;
+
+/*
+    In-place iterative radix-2 FFT with precomputed bit reversal and
+    twiddles; one plan serves every channel.
+*/
+struct FftPlan {
+    size_t               n = 0;
+    std::vector<uint32_t> bitrev;
+    std::vector<cplx>     twiddle;   // e^{-2πik/n}, k < n/2
+
+    void init(size_t size) {
+        n = size;
+        int bits = 0;
+        while (((size_t)1 << bits) < n) bits++;
+        bitrev.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t r = 0;
+            for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1u) << (bits - 1 - b);
+            bitrev[i] = r;
+        }
+        twiddle.resize(n / 2);
+        for (size_t k = 0; k < n / 2; ++k) twiddle[k] = std::polar(1.0, -2.0 * M_PI * (double)k / (double)n);
+    }
+
+    void forward(cplx *x) const {
+        for (size_t i = 0; i < n; ++i) {
+            if (i < bitrev[i]) std::swap(x[i], x[bitrev[i]]);
+        }
+        for (size_t len = 2; len <= n; len <<= 1) {
+            size_t half = len / 2, step = n / len;
+            for (size_t i = 0; i < n; i += len) {
+                for (size_t j = 0; j < half; ++j) {
+                    cplx u = x[i + j];
+                    cplx v = x[i + j + half] * twiddle[j * step];
+                    x[i + j] = u + v;
+                    x[i + j + half] = u - v;
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,170 @@
+/*
+    ================================================================
+              OUTPUT CURVE BENCHMARK (host, or any target)
+    ================================================================
+
+    Per-frame cycles of the output pass at this build's NUM_LEDS, over
+    rendered frames from after the ramp-in, for two LED responses: the
+    configured LED_RESPONSE_GAMMA and a γ = 2.2 LED.
+
+      powf     the curve evaluated per channel byte with powf(), then
+               master level and truncation
+      table    applyOutputCurve(): one table read per channel byte
+      dither   TemporalDither::apply(), the table pass ledOutputShow()
+               runs by default
+
+    Every table entry must be within one level (1/256 LSB) of the powf()
+    curve; the run fails otherwise. Bytes the powf and table passes send
+    differently are counted. Build with -DHOT_PATH_PROFILER=0.
+
+    Usage: gamma_bench [frames]
+*/
+
+#include <FastLED.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "config.h"
+#include "cycles.h"
+#include "dither.h"
+#include "gamma.h"
+#include "render.h"
+#include "session_program.h"
+#include "topology.h"
+
+struct BenchCurve {
+    char        name[32];
+    float       gamma[3];
+    OutputCurve table;
+    float       inverse[3];   // powf() exponents
+};
+
+/* ---------------- POWF REFERENCE ---------------- */
+
+static uint16_t powfLevel(const BenchCurve &bc, int c, uint8_t v) {
+    return (uint16_t)(OUTPUT_LEVEL_MAX * powf(v * (1.0f / 255.0f), bc.inverse[c]) + 0.5f);
+}
+
+static void applyPowf(const BenchCurve &bc, CRGB *leds, uint32_t master) {
+    uint8_t *bytes = (uint8_t *)leds;
+    for (int i = 0; i < NUM_LEDS; ++i, bytes += 3) {
+        for (int c = 0; c < 3; ++c) bytes[c] = (uint8_t)((powfLevel(bc, c, bytes[c]) * master) >> 24);
+    }
+}
+
+/* ---------------- TIMING ---------------- */
+
+enum Pass { PASS_POWF, PASS_TABLE, PASS_DITHER, PASS_COUNT };
+static const char *const PASS_NAMES[PASS_COUNT] = {"powf", "table", "dither"};
+
+static void runPass(Pass pass, const BenchCurve &bc, CRGB *leds, uint32_t master) {
+    static TemporalDither dither;
+    switch (pass) {
+        case PASS_POWF:   applyPowf(bc, leds, master); break;
+        case PASS_TABLE:  applyOutputCurve(bc.table, leds, master); break;
+        case PASS_DITHER: dither.apply(bc.table, leds, master); break;
+        default: break;
+    }
+}
+
+// Median cycles per frame over `frames`, best of three passes
+static uint32_t timePass(Pass pass, const BenchCurve &bc, const std::vector<CRGB> &frames, CRGB *leds,
+                         uint32_t master) {
+    size_t count = frames.size() / NUM_LEDS;
+    std::vector<uint32_t> cycles(count);
+    uint32_t best = UINT32_MAX;
+    for (int rep = 0; rep < 3; ++rep) {
+        for (size_t f = 0; f < count; ++f) {
+            memcpy(leds, &frames[f * NUM_LEDS], NUM_LEDS * sizeof(CRGB));
+            uint32_t c0 = readCycleCounter();
+            runPass(pass, bc, leds, master);
+            cycles[f] = readCycleCounter() - c0;
+        }
+        std::nth_element(cycles.begin(), cycles.begin() + cycles.size() / 2, cycles.end());
+        best = std::min(best, cycles[cycles.size() / 2]);
+    }
+    return best;
+}
+
+/* ---------------- MAIN ---------------- */
+
+int main(int argc, char **argv) {
+    int frames = (argc > 1) ? atoi(argv[1]) : 500;
+    if (frames < 1) frames = 1;
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        fprintf(stderr, "session program: %s\n", activeProgram().error);
+        return 1;
+    }
+
+    OscillatorBank bank;
+    bank.init();
+    uint64_t startUs = (uint64_t)(RAMP_IN_SECONDS * 1e6f);
+    std::vector<CRGB> rendered((size_t)frames * NUM_LEDS);
+    for (int f = 0; f < frames; ++f) {
+        renderFrame(computeFrameParams(bank, startUs + (uint64_t)f * FRAME_PERIOD_US), &rendered[f * NUM_LEDS]);
+    }
+
+    static BenchCurve curves[2];
+    const float steep[3] = {2.2f, 2.2f, 2.2f};
+    for (int k = 0; k < 2; ++k) {
+        BenchCurve &bc = curves[k];
+        for (int c = 0; c < 3; ++c) {
+            // volatile: keep the compiler from folding powf() for a constant exponent
+            volatile float g = (k == 0) ? LED_RESPONSE_GAMMA[c] : steep[c];
+            bc.gamma[c] = g;
+            bc.inverse[c] = 1.0f / g;
+        }
+        bc.table = makeOutputCurve(bc.gamma);
+        snprintf(bc.name, sizeof(bc.name), "%s %.2f/%.2f/%.2f", k == 0 ? "config" : "steep", bc.gamma[0],
+                 bc.gamma[1], bc.gamma[2]);
+    }
+
+    static CRGB a[NUM_LEDS], b[NUM_LEDS];
+    const uint32_t master = outputMaster(sessionLevel(RAMP_IN_SECONDS));
+    double mhz = (double)cycleCounterHz() * 1e-6;
+    bool ok = true;
+
+    printf("%s, NUM_LEDS %d, %d frames, level %.4f, %.0f MHz counter%s\n", topology().name, NUM_LEDS, frames,
+           sessionLevel(RAMP_IN_SECONDS), mhz, USE_HOT_PATH_PROFILER ? " (profiler stamps enabled)" : "");
+    printf("%-24s", "LED gamma R/G/B");
+    for (const char *name : PASS_NAMES) printf(" %10s", name);
+    printf(" %8s %9s %9s\n", "speedup", "max diff", "bytes off");
+
+    for (const BenchCurve &bc : curves) {
+        int maxDiff = 0;
+        for (int c = 0; c < 3; ++c) {
+            for (int v = 0; v < 256; ++v) maxDiff = std::max(maxDiff, abs(bc.table.level[c][v] - powfLevel(bc, c, v)));
+        }
+        uint64_t bytesOff = 0;
+        for (int f = 0; f < frames; ++f) {
+            memcpy(a, &rendered[f * NUM_LEDS], sizeof(a));
+            memcpy(b, a, sizeof(b));
+            applyPowf(bc, a, master);
+            applyOutputCurve(bc.table, b, master);
+            const uint8_t *pa = (const uint8_t *)a, *pb = (const uint8_t *)b;
+            for (int k = 0; k < NUM_LEDS * 3; ++k) bytesOff += (pa[k] != pb[k]);
+        }
+
+        uint32_t cycles[PASS_COUNT];
+        printf("%-24s", bc.name);
+        for (int p = 0; p < PASS_COUNT; ++p) {
+            cycles[p] = timePass((Pass)p, bc, rendered, a, master);
+            printf(" %10u", (unsigned)cycles[p]);
+        }
+        printf(" %7.1fx %9d %9llu\n", (double)cycles[PASS_POWF] / (double)cycles[PASS_TABLE], maxDiff,
+               (unsigned long long)bytesOff);
+        if (maxDiff > 1) ok = false;
+    }
+    printf("cycles per frame (median); speedup = powf / table; diff in 1/256 LSB levels\n");
+
+    if (!ok) {
+        printf("FAIL: table differs from powf() by more than one level\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,336 @@
+/*
+    ================================================================
+                  GOLDEN FRAME REGRESSION CHECK (host)
+    ================================================================
+
+    Renders selected frames of the session and compares them, byte for
+    byte, with the reference frames committed in tools/golden/ (format in
+    golden_file.h). A change to the masks, colours, topology or output
+    curve shows up here as frames outside the tolerance, with the window,
+    time, LED and channel of the worst one.
+
+    A frame is rendered for the moment it becomes visible, as
+    render_session does, and sent through the curve and master level
+    without temporal dithering or the power limiter. Those carry state
+    from frame to frame and have their own checks (dither_check,
+    power_check), and without them any frame can be rendered on its own.
+    The windows:
+
+      ramp-in          the first second, then every RAMP_STRIDE_FRAMES
+                       to the end of the program's first segment
+      mode <name>      MODE_FRAMES frames of each mandala mode, starting
+                       MODE_SETTLE_FRAMES into its first run after the
+                       ramp-in
+      mode boundary    BOUNDARY_FRAMES either side of every multiple of
+                       MODE_DURATION and of every other mode change
+      fade-out         every frame from the end of the stimulus to black
+
+    -u writes the goldens from this build instead of checking them. Do
+    that when a change to the picture is intended, and commit the file
+    with it. Goldens are per program, layout and NUM_LEDS (the default
+    file name says which). The run fails if any frame differs by more
+    than the per-channel tolerance (-t, in LSB of the bytes sent). By
+    default a build must match goldens from its own render path exactly;
+    a colour change of a few LSB can come out as a single LSB after the
+    curve and master level. A Q15 build checked against float goldens
+    gets Q15_TOLERANCE_LSB. -t 1 also absorbs float rounding
+    differences from another compiler or FPU.
+
+    Usage: golden_check [-u] [-f file] [-t lsb | -t r,g,b] [-p program]
+*/
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "gamma.h"
+#include "golden_file.h"
+#include "presentation.h"
+#include "render.h"
+#include "session_program.h"
+#include "topology.h"
+
+constexpr uint32_t RAMP_START_FRAMES  = 100;   // 1 s at 100 FPS
+constexpr uint32_t RAMP_STRIDE_FRAMES = 50;
+constexpr uint32_t MODE_SETTLE_FRAMES = 100;
+constexpr uint32_t MODE_FRAMES        = 100;
+constexpr uint32_t BOUNDARY_FRAMES    = 4;
+
+constexpr int Q15_TOLERANCE_LSB = 1;   // after the curve, on every built-in layout
+
+static const char *const MODE_NAMES[3] = {"radial", "spiral", "interference"};
+
+static uint64_t frameVisibleUs(uint64_t frame) {
+    uint64_t us = frame * FRAME_PERIOD_US;
+    if (USE_PRESENTATION_COMPENSATION) us += WIRE_PRESENTATION_US;
+    return us;
+}
+
+static float frameSeconds(uint64_t frame) {
+    return (float)frameVisibleUs(frame) * 0.000001f;
+}
+
+// Frames before the fade-out reaches black
+static uint32_t sessionFrameCount() {
+    uint32_t n = 0;
+    while (!sessionFinished(frameSeconds(n))) n++;
+    return n;
+}
+
+/*
+    The bytes frame `k` sends, physical LED order. Frames must be asked
+    for in ascending order; the bank seeks forward between them.
+*/
+static void renderGolden(OscillatorBank &bank, uint32_t k, uint8_t *rgb) {
+    uint64_t us = frameVisibleUs(k);
+    bank.seek(us);
+    FrameParams fp = computeFrameParams(bank, us);
+    CRGB frame[NUM_LEDS];
+    renderFrame(fp, frame);
+    applyOutputCurve(outputCurve(), frame, outputMaster(fp.master));
+    memcpy(rgb, frame, sizeof(frame));
+}
+
+/* ---------------- FRAME SELECTION ---------------- */
+
+struct Selection {
+    std::vector<std::string>    windows;
+    std::map<uint32_t, uint8_t> frames;   // frame -> window; the first window to pick it keeps it
+
+    uint8_t window(const char *name) {
+        windows.push_back(name);
+        return (uint8_t)(windows.size() - 1);
+    }
+
+    void add(uint64_t first, uint64_t count, uint32_t total, uint8_t w) {
+        for (uint64_t k = first; k < first + count && k < total; ++k) frames.emplace((uint32_t)k, w);
+    }
+};
+
+static Selection selectFrames() {
+    Selection sel;
+    const uint32_t total = sessionFrameCount();
+    const float rampEnd = activeProgram().source->segments[0].seconds;
+
+    // Mode of every frame, from the same frame parameters the render uses
+    std::vector<uint8_t> mode(total);
+    OscillatorBank bank;
+    bank.init();
+    for (uint32_t k = 0; k < total; ++k) mode[k] = (uint8_t)computeFrameParams(bank, frameVisibleUs(k)).mandalaMode;
+
+    uint8_t w = sel.window("ramp-in");
+    sel.add(0, RAMP_START_FRAMES, total, w);
+    for (uint32_t k = RAMP_START_FRAMES; k < total && frameSeconds(k) < rampEnd; k += RAMP_STRIDE_FRAMES) {
+        sel.add(k, 1, total, w);
+    }
+
+    for (int m = 0; m < 3; ++m) {
+        char name[GOLDEN_NAME_BYTES];
+        snprintf(name, sizeof(name), "mode %s", MODE_NAMES[m]);
+        w = sel.window(name);
+        // First run of the mode after the ramp-in, else anywhere
+        uint32_t start = total;
+        for (int pass = 0; pass < 2 && start == total; ++pass) {
+            for (uint32_t k = 1; k < total; ++k) {
+                if (mode[k] == m && mode[k - 1] != m && (pass == 1 || frameSeconds(k) >= rampEnd)) {
+                    start = k;
+                    break;
+                }
+            }
+            if (start == total && mode[0] == m) start = 0;
+        }
+        if (start < total) sel.add(start + MODE_SETTLE_FRAMES, MODE_FRAMES, total, w);
+    }
+
+    w = sel.window("mode boundary");
+    for (uint32_t k = 1; k < total; ++k) {
+        bool multiple = (uint64_t)(frameVisibleUs(k - 1) / (uint64_t)(MODE_DURATION * 1e6f)) !=
+                        (uint64_t)(frameVisibleUs(k) / (uint64_t)(MODE_DURATION * 1e6f));
+        if (multiple || mode[k] != mode[k - 1]) sel.add(k - BOUNDARY_FRAMES, 2 * BOUNDARY_FRAMES, total, w);
+    }
+
+    w = sel.window("fade-out");
+    uint32_t fadeStart = 0;
+    while (fadeStart < total && frameSeconds(fadeStart) <= sessionEndSeconds()) fadeStart++;
+    sel.add(fadeStart, total - fadeStart, total, w);
+    return sel;
+}
+
+/* ---------------- UPDATE ---------------- */
+
+static uint32_t buildFlags() {
+    return (RENDER_FIXED_POINT ? GOLDEN_FLAG_FIXED_POINT : 0) |
+           (USE_PRESENTATION_COMPENSATION ? GOLDEN_FLAG_PRESENTATION : 0);
+}
+
+static int writeGoldens(const char *path, int program) {
+    Selection sel = selectFrames();
+    GoldenSet set;
+    set.header.numLeds       = NUM_LEDS;
+    set.header.framePeriodUs = FRAME_PERIOD_US;
+    set.header.flags         = buildFlags();
+    set.header.program       = program;
+    set.header.layout        = LED_LAYOUT;
+    set.windows              = sel.windows;
+
+    OscillatorBank bank;
+    bank.init();
+    for (const auto &f : sel.frames) {
+        GoldenFrame g = {f.first, f.second, std::vector<uint8_t>(NUM_LEDS * 3)};
+        renderGolden(bank, f.first, g.rgb.data());
+        set.frames.push_back(std::move(g));
+    }
+    if (!set.save(path)) return 1;
+
+    // The coder must reproduce every byte
+    GoldenSet back;
+    if (!back.load(path)) return 1;
+    for (size_t k = 0; k < set.frames.size(); ++k) {
+        if (back.frames[k].frame != set.frames[k].frame || back.frames[k].rgb != set.frames[k].rgb) {
+            fprintf(stderr, "%s: frame %u does not read back\n", path, (unsigned)set.frames[k].frame);
+            return 1;
+        }
+    }
+
+    FILE *f = fopen(path, "rb");
+    long bytes = 0;
+    if (f != nullptr) {
+        fseek(f, 0, SEEK_END);
+        bytes = ftell(f);
+        fclose(f);
+    }
+    printf("%s: %zu frames in %zu windows, %ld bytes (%.1f %% of raw)\n", path, set.frames.size(),
+           set.windows.size(), bytes, 100.0 * bytes / ((double)set.frames.size() * NUM_LEDS * 3));
+    return 0;
+}
+
+/* ---------------- CHECK ---------------- */
+
+struct WindowStats {
+    uint32_t frames = 0;
+    uint32_t failed = 0;      // frames with any byte outside the tolerance
+    int      maxDiff[3] = {};
+};
+
+static int checkGoldens(const char *path, int program, const int *tolArg) {
+    GoldenSet set;
+    if (!set.load(path)) return 1;
+    const GoldenFileHeader &h = set.header;
+    if (h.numLeds != NUM_LEDS || h.layout != LED_LAYOUT || h.program != program ||
+        h.framePeriodUs != FRAME_PERIOD_US) {
+        fprintf(stderr, "%s: goldens are for program %d, LED_LAYOUT %d, NUM_LEDS %u, %u us frames; "
+                        "this run is %d, %d, %d, %u us\n", path, (int)h.program, (int)h.layout,
+                (unsigned)h.numLeds, (unsigned)h.framePeriodUs, program, LED_LAYOUT, NUM_LEDS,
+                (unsigned)FRAME_PERIOD_US);
+        return 1;
+    }
+    if ((h.flags & GOLDEN_FLAG_PRESENTATION) != (buildFlags() & GOLDEN_FLAG_PRESENTATION)) {
+        fprintf(stderr, "%s: recorded with presentation compensation %s\n", path,
+                (h.flags & GOLDEN_FLAG_PRESENTATION) ? "on" : "off");
+        return 1;
+    }
+
+    bool crossPath = (h.flags & GOLDEN_FLAG_FIXED_POINT) != (buildFlags() & GOLDEN_FLAG_FIXED_POINT);
+    int tol[3];
+    for (int c = 0; c < 3; ++c) tol[c] = tolArg ? tolArg[c] : (crossPath ? Q15_TOLERANCE_LSB : 0);
+
+    std::vector<WindowStats> stats(set.windows.size());
+    struct { int diff = 0; uint32_t frame = 0; int led = 0, c = 0, got = 0, want = 0; uint8_t w = 0; } worst;
+    uint8_t rgb[NUM_LEDS * 3];
+    OscillatorBank bank;
+    bank.init();
+    for (const GoldenFrame &g : set.frames) {
+        renderGolden(bank, g.frame, rgb);
+        WindowStats &s = stats[g.window];
+        s.frames++;
+        bool failed = false;
+        for (int i = 0; i < NUM_LEDS * 3; ++i) {
+            int c = i % 3;
+            int diff = abs((int)rgb[i] - (int)g.rgb[i]);
+            if (diff > s.maxDiff[c]) s.maxDiff[c] = diff;
+            if (diff > tol[c]) failed = true;
+            if (diff - tol[c] > worst.diff - tol[worst.c]) {
+                worst.diff = diff;
+                worst.frame = g.frame;
+                worst.led = i / 3;
+                worst.c = c;
+                worst.got = rgb[i];
+                worst.want = g.rgb[i];
+                worst.w = g.window;
+            }
+        }
+        if (failed) s.failed++;
+    }
+
+    printf("%s: program %d, %s, NUM_LEDS %d, %s path against %s goldens, tolerance %d/%d/%d LSB\n", path,
+           program, topology().name, NUM_LEDS, RENDER_FIXED_POINT ? "Q15" : "float",
+           (h.flags & GOLDEN_FLAG_FIXED_POINT) ? "Q15" : "float", tol[0], tol[1], tol[2]);
+    printf("%-22s %7s %7s %13s\n", "window", "frames", "failed", "max diff rgb");
+    uint32_t failed = 0;
+    for (size_t w = 0; w < stats.size(); ++w) {
+        const WindowStats &s = stats[w];
+        printf("%-22s %7u %7u %5d/%d/%d\n", set.windows[w].c_str(), (unsigned)s.frames, (unsigned)s.failed,
+               s.maxDiff[0], s.maxDiff[1], s.maxDiff[2]);
+        failed += s.failed;
+    }
+    if (failed > 0) {
+        printf("worst: %s frame %u (%.2f s), LED %d %c: %d, golden %d\n", set.windows[worst.w].c_str(),
+               (unsigned)worst.frame, frameSeconds(worst.frame), worst.led, "rgb"[worst.c], worst.got,
+               worst.want);
+        printf("FAIL: %u of %zu frames outside the tolerance\n", (unsigned)failed, set.frames.size());
+        return 1;
+    }
+    printf("pass\n");
+    return 0;
+}
+
+/* ---------------- MAIN ---------------- */
+
+static void usage() {
+    fprintf(stderr, "usage: golden_check [-u] [-f file] [-t lsb | -t r,g,b] [-p program]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    bool update = false;
+    const char *path = nullptr;
+    int program = ACTIVE_SESSION_PROGRAM;
+    int tol[3];
+    bool haveTol = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-u") == 0) {
+            update = true;
+            continue;
+        }
+        if (i + 1 >= argc) usage();
+        if      (strcmp(argv[i], "-f") == 0) path = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0) program = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0) {
+            int n = sscanf(argv[++i], "%d,%d,%d", &tol[0], &tol[1], &tol[2]);
+            if (n == 1) tol[1] = tol[2] = tol[0];
+            else if (n != 3) usage();
+            if (tol[0] < 0 || tol[1] < 0 || tol[2] < 0) usage();
+            haveTol = true;
+        }
+        else usage();
+    }
+    if (!loadSessionProgram(program)) {
+        fprintf(stderr, "session program %d: %s (segment %d)\n", program, activeProgram().error,
+                activeProgram().errorSegment);
+        return 1;
+    }
+
+    char defaultPath[96];
+    snprintf(defaultPath, sizeof(defaultPath), "tools/golden/program%d-layout%d-%d.gold", program,
+             LED_LAYOUT, NUM_LEDS);
+    if (path == nullptr) path = defaultPath;
+
+    return update ? writeGoldens(path, program) : checkGoldens(path, program, haveTol ? tol : nullptr);
+}
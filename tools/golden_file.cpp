@@ -0,0 +1,248 @@
+#include "golden_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* ---------------- PREDICTION ---------------- */
+
+/*
+    Predicted bytes of frame `frame` from the two golden frames before
+    it (prev at frame prevFrame, prev2 at prev2Frame), as in the header.
+*/
+static void predict(uint32_t frame, const uint8_t *prev, uint32_t prevFrame, const uint8_t *prev2,
+                    uint32_t prev2Frame, bool havePrev2, uint8_t *pred, size_t n) {
+    bool linear = havePrev2 && frame - prevFrame == prevFrame - prev2Frame;
+    for (size_t i = 0; i < n; ++i) {
+        int p = linear ? 2 * prev[i] - prev2[i] : prev[i];
+        pred[i] = (uint8_t)(p < 0 ? 0 : (p > 255 ? 255 : p));
+    }
+}
+
+static uint32_t zigzag(uint8_t cur, uint8_t pred) {
+    int d = (int8_t)(uint8_t)(cur - pred);
+    return (uint32_t)((d << 1) ^ (d >> 31)) & 0xff;
+}
+
+static uint8_t unzigzag(uint32_t z, uint8_t pred) {
+    int d = (int)(z >> 1) ^ -(int)(z & 1);
+    return (uint8_t)(pred + d);
+}
+
+/* ---------------- BIT CODING ---------------- */
+
+static void putVarint(std::vector<uint8_t> &out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+struct BitWriter {
+    std::vector<uint8_t> &out;
+    uint32_t              acc = 0;
+    int                   bits = 0;
+
+    void put(uint32_t v, int n) {
+        for (int b = n - 1; b >= 0; --b) {
+            acc = (acc << 1) | ((v >> b) & 1);
+            if (++bits == 8) {
+                out.push_back((uint8_t)acc);
+                acc = 0;
+                bits = 0;
+            }
+        }
+    }
+
+    void flush() {
+        if (bits > 0) put(0, 8 - bits);
+    }
+};
+
+static uint32_t riceBits(uint32_t z, int k) {
+    uint32_t q = z >> k;
+    return (q < GOLDEN_RICE_ESCAPE) ? q + 1 + k : GOLDEN_RICE_ESCAPE + 8;
+}
+
+static void putRice(BitWriter &w, uint32_t z, int k) {
+    uint32_t q = z >> k;
+    if (q < GOLDEN_RICE_ESCAPE) {
+        w.put((1u << (q + 1)) - 2, (int)q + 1);   // q ones, then a zero
+        w.put(z, k);
+    } else {
+        w.put((1u << GOLDEN_RICE_ESCAPE) - 1, GOLDEN_RICE_ESCAPE);
+        w.put(z, 8);
+    }
+}
+
+struct Reader {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool           ok = true;
+    uint32_t       acc = 0;
+    int            bits = 0;
+
+    uint8_t byte() {
+        if (p == end) {
+            ok = false;
+            return 0;
+        }
+        return *p++;
+    }
+
+    uint32_t varint() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t b = byte();
+            v |= (uint32_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint32_t bit() {
+        if (bits == 0) {
+            acc = byte();
+            bits = 8;
+        }
+        return (acc >> --bits) & 1;
+    }
+
+    uint32_t get(int n) {
+        uint32_t v = 0;
+        for (int b = 0; b < n; ++b) v = (v << 1) | bit();
+        return v;
+    }
+
+    uint32_t rice(int k) {
+        uint32_t q = 0;
+        while (q < GOLDEN_RICE_ESCAPE && bit() == 1) q++;
+        if (q == GOLDEN_RICE_ESCAPE) return get(8);
+        return (q << k) | get(k);
+    }
+
+    // The next frame starts on a byte boundary
+    void align() { bits = 0; }
+};
+
+/* ---------------- FILES ---------------- */
+
+bool GoldenSet::load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr) {
+        perror(path);
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + got);
+    fclose(f);
+
+    const GoldenFileHeader &h = header;
+    bool ok = data.size() >= sizeof(GoldenFileHeader);
+    if (ok) {
+        memcpy(&header, data.data(), sizeof(header));
+        ok = memcmp(h.magic, GOLDEN_FILE_MAGIC, sizeof(h.magic)) == 0 && h.version == GOLDEN_FILE_VERSION &&
+             h.headerBytes >= sizeof(GoldenFileHeader) && h.windowCount <= 256 &&
+             h.headerBytes + (size_t)h.windowCount * GOLDEN_NAME_BYTES <= data.size();
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: not a version %u golden file\n", path, (unsigned)GOLDEN_FILE_VERSION);
+        return false;
+    }
+
+    const uint8_t *names = data.data() + h.headerBytes;
+    windows.clear();
+    for (uint32_t w = 0; w < h.windowCount; ++w) {
+        const char *name = (const char *)names + w * GOLDEN_NAME_BYTES;
+        windows.emplace_back(name, strnlen(name, GOLDEN_NAME_BYTES));
+    }
+
+    Reader in = {names + h.windowCount * GOLDEN_NAME_BYTES, data.data() + data.size()};
+    const size_t n = (size_t)h.numLeds * 3;
+    std::vector<uint8_t> black(n, 0), pred(n);
+    uint32_t frame = 0;
+    frames.clear();
+    for (uint32_t k = 0; k < h.frameCount && ok; ++k) {
+        frame += in.varint();
+        uint8_t window = in.byte();
+        int rice = in.byte();
+        ok = in.ok && window < h.windowCount && rice < 8 && (k == 0 || frame > frames.back().frame);
+        if (!ok) break;
+
+        const GoldenFrame *p1 = (k > 0) ? &frames[k - 1] : nullptr;
+        const GoldenFrame *p2 = (k > 1) ? &frames[k - 2] : nullptr;
+        predict(frame, p1 ? p1->rgb.data() : black.data(), p1 ? p1->frame : 0,
+                p2 ? p2->rgb.data() : black.data(), p2 ? p2->frame : 0, p2 != nullptr, pred.data(), n);
+        GoldenFrame g = {frame, window, std::vector<uint8_t>(n)};
+        for (size_t i = 0; i < n; ++i) g.rgb[i] = unzigzag(in.rice(rice), pred[i]);
+        in.align();
+        ok = in.ok;
+        frames.push_back(std::move(g));
+    }
+    if (!ok || in.p != in.end) {
+        fprintf(stderr, "%s: corrupt frame data\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool GoldenSet::save(const char *path) const {
+    std::vector<uint8_t> out(sizeof(GoldenFileHeader));
+    GoldenFileHeader h = header;
+    memcpy(h.magic, GOLDEN_FILE_MAGIC, sizeof(h.magic));
+    h.version     = GOLDEN_FILE_VERSION;
+    h.headerBytes = sizeof(GoldenFileHeader);
+    h.windowCount = (uint32_t)windows.size();
+    h.frameCount  = (uint32_t)frames.size();
+    memcpy(out.data(), &h, sizeof(h));
+
+    for (const std::string &w : windows) {
+        char name[GOLDEN_NAME_BYTES] = {};
+        strncpy(name, w.c_str(), GOLDEN_NAME_BYTES - 1);
+        out.insert(out.end(), name, name + GOLDEN_NAME_BYTES);
+    }
+
+    const size_t n = (size_t)h.numLeds * 3;
+    std::vector<uint8_t> black(n, 0), pred(n);
+    std::vector<uint32_t> z(n);
+    for (size_t k = 0; k < frames.size(); ++k) {
+        const GoldenFrame &g = frames[k];
+        const GoldenFrame *p1 = (k > 0) ? &frames[k - 1] : nullptr;
+        const GoldenFrame *p2 = (k > 1) ? &frames[k - 2] : nullptr;
+        predict(g.frame, p1 ? p1->rgb.data() : black.data(), p1 ? p1->frame : 0,
+                p2 ? p2->rgb.data() : black.data(), p2 ? p2->frame : 0, p2 != nullptr, pred.data(), n);
+
+        // Cheapest Rice parameter for this frame's residuals
+        int best = 0;
+        uint64_t bestBits = UINT64_MAX;
+        for (size_t i = 0; i < n; ++i) z[i] = zigzag(g.rgb[i], pred[i]);
+        for (int rice = 0; rice < 8; ++rice) {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; ++i) bits += riceBits(z[i], rice);
+            if (bits < bestBits) {
+                bestBits = bits;
+                best = rice;
+            }
+        }
+
+        putVarint(out, g.frame - (p1 ? p1->frame : 0));
+        out.push_back(g.window);
+        out.push_back((uint8_t)best);
+        BitWriter w = {out};
+        for (size_t i = 0; i < n; ++i) putRice(w, z[i], best);
+        w.flush();
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (f == nullptr) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) perror(path);
+    return ok;
+}
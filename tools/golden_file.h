@@ -0,0 +1,84 @@
+/*
+    ================================================================
+                     GOLDEN FRAME FILE FORMAT (host)
+    ================================================================
+
+    Reference frames for golden_check: selected frames of a session as
+    sent to the strip, plus the named windows they were picked for.
+    Little-endian:
+
+        GoldenFileHeader                       64 bytes
+        char name[GOLDEN_NAME_BYTES][windowCount]
+                                               window names, NUL-padded
+        frame[frameCount]                      in ascending frame order
+            varint  frameDelta                 frame index minus the previous
+                                               one (the first: minus 0)
+            uint8_t window                     index into the names
+            uint8_t k                          Rice parameter, 0..7
+            bits                               one code per byte, MSB
+                                               first, padded to a byte
+
+    Each byte is coded as its residual against a prediction from the
+    golden frames before it (the first frame is predicted as black):
+
+        prev                                   the previous golden frame
+        2 * prev - prev2, clamped to 0..255    when the three frames are
+                                               evenly spaced (prev2 golden
+                                               frame before prev)
+
+    The flicker is smooth at the frame rate, so in runs of consecutive
+    frames the linear prediction is usually within a few LSB. The
+    residual (cur - pred as int8, zigzagged to 0..255) is Rice-coded with
+    the frame's best k: q = z >> k as q one bits and a zero, then the k
+    low bits of z. From q >= GOLDEN_RICE_ESCAPE there are only
+    GOLDEN_RICE_ESCAPE one bits, then all 8 bits of z. Varints are LEB128,
+    7 bits per byte.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+constexpr char     GOLDEN_FILE_MAGIC[8] = {'T', 'H', 'E', 'T', 'A', 'G', 'L', 'D'};
+constexpr uint32_t GOLDEN_FILE_VERSION = 1;
+constexpr int      GOLDEN_NAME_BYTES = 24;
+constexpr uint32_t GOLDEN_RICE_ESCAPE = 12;
+
+// GoldenFileHeader::flags, as SESSION_FLAG_* (session_file.h)
+constexpr uint32_t GOLDEN_FLAG_FIXED_POINT  = 1u << 0;   // rendered with the Q15 path
+constexpr uint32_t GOLDEN_FLAG_PRESENTATION = 1u << 1;   // presentation-compensated times
+
+struct GoldenFileHeader {
+    char     magic[8];        // GOLDEN_FILE_MAGIC
+    uint32_t version;         // GOLDEN_FILE_VERSION
+    uint32_t headerBytes;     // offset of the window names
+    uint32_t numLeds;
+    uint32_t framePeriodUs;
+    uint32_t flags;           // GOLDEN_FLAG_*
+    int32_t  program;         // session program index
+    int32_t  layout;          // LED_LAYOUT
+    uint32_t windowCount;
+    uint32_t frameCount;
+    uint32_t reserved[5];
+};
+
+static_assert(sizeof(GoldenFileHeader) == 64, "golden header layout");
+
+struct GoldenFrame {
+    uint32_t             frame;    // session frame index
+    uint8_t              window;
+    std::vector<uint8_t> rgb;      // numLeds * 3, physical LED order
+};
+
+struct GoldenSet {
+    GoldenFileHeader         header = {};
+    std::vector<std::string> windows;
+    std::vector<GoldenFrame> frames;
+
+    // false (and prints why) if the file is missing or malformed
+    bool load(const char *path);
+    bool save(const char *path) const;
+};
@@ -0,0 +1,269 @@
+/*
+    ================================================================
+               RENDER KERNEL BENCHMARK (host and target)
+    ================================================================
+
+    Times each render kernel on its own, and the whole per-frame work
+    of loop(), at this build's NUM_LEDS and trig backend:
+
+      spiralMask, radialMask, interferenceMask
+                      one call per body LED, at its topology coordinate
+      mixColor        one call per body LED, weight along the spiral
+      expPulse, getEnhancedPhase
+                      pulse-modulation scalars, swept over as many
+                      phases as there are body LEDs
+      echo            renderEcho*(): edge core and reflection echo
+      frame           computeFrameParams(), the render path and the
+                      output pass (power limiter, temporal dither):
+                      everything loop() does per frame except show()
+
+    Kernels with a fixed-point twin run both ways. A record's backend
+    is the path it measures:
+
+      float   float path with the sinf()/expf() trig (TRIG_USE_LUT=0)
+      lut     float path with the Q15 trig tables (TRIG_USE_LUT=1)
+      q15     the integer path (render_q15.cpp), which uses the tables
+              whatever TRIG_USE_LUT says
+
+    so the float-vs-LUT comparison takes two builds (kernel_bench and
+    kernel_bench_float envs, each at 20 / 300 / 3000 / 30000 LEDs).
+    Frame parameters come from successive session frames after the
+    ramp-in. Each figure is the median over the frames, best of three
+    passes. Build with -DHOT_PATH_PROFILER=0.
+
+    Output is JSON Lines, one self-contained record per kernel and
+    backend, so runs of several builds can be concatenated and compared:
+
+      {"kernel":"radialMask","backend":"lut","platform":"host",
+       "layout":"spiral strip","num_leds":20,"calls":16,"cycles":250,
+       "cycles_per_call":15.62,"us":0.119}
+
+    On the host, cycles are TSC ticks. The same source builds for the
+    ESP32 (kernel_bench_esp32 envs), where cycles are CCOUNT core cycles
+    and the records go out over serial once after boot.
+
+    Usage: kernel_bench [frames]
+*/
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "config.h"
+#include "cycles.h"
+#include "dither.h"
+#include "gamma.h"
+#include "power.h"
+#include "render.h"
+#include "session_program.h"
+#include "telemetry.h"
+#include "topology.h"
+#include "trig.h"
+
+#if defined(ARDUINO)
+static const char *const PLATFORM = "esp32";
+#else
+static const char *const PLATFORM = "host";
+#endif
+
+static const char *const FLOAT_BACKEND = TRIG_USE_LUT ? "lut" : "float";
+
+constexpr int BODY_FIRST = ANCHOR_LEDS;
+constexpr int BODY_LEDS  = NUM_LEDS - ANCHOR_LEDS - EDGE_LEDS;
+
+// Results land here so the compiler cannot drop the calls
+static volatile float    sinkF;
+static volatile uint32_t sinkU;
+
+/* ---------------- HARNESS ---------------- */
+
+/*
+    Median cycles of `run(fp)` over `params`, best of three passes.
+    `run` makes its calls for one frame's parameters.
+*/
+template <typename Run>
+static uint32_t timeKernel(Run run, const std::vector<FrameParams> &params) {
+    std::vector<uint32_t> cycles(params.size());
+    uint32_t best = UINT32_MAX;
+    for (int pass = 0; pass < 3; ++pass) {
+        for (size_t f = 0; f < params.size(); ++f) {
+            uint32_t c0 = readCycleCounter();
+            run(params[f]);
+            cycles[f] = readCycleCounter() - c0;
+        }
+        std::nth_element(cycles.begin(), cycles.begin() + cycles.size() / 2, cycles.end());
+        best = std::min(best, cycles[cycles.size() / 2]);
+    }
+    return best;
+}
+
+static void emit(const char *kernel, const char *backend, int calls, uint32_t cycles) {
+    double us = (double)cycles * 1e6 / (double)cycleCounterHz();
+    consolePrintf("{\"kernel\":\"%s\",\"backend\":\"%s\",\"platform\":\"%s\",\"layout\":\"%s\","
+                  "\"num_leds\":%d,\"calls\":%d,\"cycles\":%u,\"cycles_per_call\":%.2f,\"us\":%.3f}\n",
+                  kernel, backend, PLATFORM, topology().name, NUM_LEDS, calls, (unsigned)cycles,
+                  (double)cycles / calls, us);
+}
+
+/* ---------------- KERNELS ---------------- */
+
+static void benchMasks(const std::vector<FrameParams> &params) {
+    const Topology &t = topology();
+
+    emit("spiralMask", FLOAT_BACKEND, BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        float shift = phase01(fp.phaseSpiralBody), acc = 0.0f;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) acc += spiralMask(t.spiral[r], shift);
+        sinkF = acc;
+    }, params));
+    emit("spiralMask", "q15", BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        q15_t acc = 0;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) acc += spiralMaskQ15(t.spiralQ32[r], fp.phaseSpiralBody);
+        sinkU = (uint32_t)acc;
+    }, params));
+
+    emit("radialMask", FLOAT_BACKEND, BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        float phase = phase01(fp.phaseCarrier), acc = 0.0f;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) acc += radialMask(t.petal[r], phase, 8);
+        sinkF = acc;
+    }, params));
+    emit("radialMask", "q15", BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        q15_t acc = 0;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) acc += radialMaskQ15(t.petalQ32[r], fp.phaseCarrier, 8);
+        sinkU = (uint32_t)acc;
+    }, params));
+
+    emit("interferenceMask", FLOAT_BACKEND, BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        float baseL = phase01(fp.phaseLeft), baseR = phase01(fp.phaseRight), acc = 0.0f;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) acc += interferenceMask(t.spiral[r], baseL, baseR);
+        sinkF = acc;
+    }, params));
+    emit("interferenceMask", "q15", BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        q15_t acc = 0;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) {
+            acc += interferenceMaskQ15(t.spiralQ32[r], fp.phaseLeft, fp.phaseRight);
+        }
+        sinkU = (uint32_t)acc;
+    }, params));
+}
+
+static void benchColor(const std::vector<FrameParams> &params) {
+    const Topology &t = topology();
+
+    emit("mixColor", FLOAT_BACKEND, BODY_LEDS, timeKernel([&](const FrameParams &) {
+        uint32_t acc = 0;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) {
+            CRGB c = mixColor(CENTER_COLOR, RIGHT_COLOR, t.spiral[r]);
+            acc += c.r + c.g + c.b;
+        }
+        sinkU = acc;
+    }, params));
+    emit("mixColor", "q15", BODY_LEDS, timeKernel([&](const FrameParams &) {
+        uint32_t acc = 0;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) {
+            CRGB c = mixColorQ15(CENTER_COLOR, RIGHT_COLOR, (q15_t)(t.spiralQ32[r] >> 17));
+            acc += c.r + c.g + c.b;
+        }
+        sinkU = acc;
+    }, params));
+}
+
+static void benchPulse(const std::vector<FrameParams> &params) {
+    const Topology &t = topology();
+
+    emit("expPulse", FLOAT_BACKEND, BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        float base = phase01(fp.phaseLeft), acc = 0.0f;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) {
+            acc += expPulse(wrapTurns(base + t.spiral[r]), PULSE_SHARPNESS);
+        }
+        sinkF = acc;
+    }, params));
+    emit("getEnhancedPhase", FLOAT_BACKEND, BODY_LEDS, timeKernel([&](const FrameParams &fp) {
+        float base = phase01(fp.phaseLeft), acc = 0.0f;
+        for (int r = BODY_FIRST; r < BODY_FIRST + BODY_LEDS; ++r) {
+            acc += getEnhancedPhase(wrapTurns(base + t.spiral[r]), PHASE_SYNC_STRENGTH);
+        }
+        sinkF = acc;
+    }, params));
+}
+
+// The echo reads body LEDs, so each backend times over a frame it rendered
+static void benchEcho(const std::vector<FrameParams> &params, CRGB *leds) {
+    renderFrameFloat(params[0], leds);
+    emit("echo", FLOAT_BACKEND, 1, timeKernel([&](const FrameParams &fp) { renderEchoFloat(fp, leds); }, params));
+    renderFrameQ15(params[0], leds);
+    emit("echo", "q15", 1, timeKernel([&](const FrameParams &fp) { renderEchoQ15(fp, leds); }, params));
+}
+
+/*
+    One loop() frame without show(): the oscillators advance a frame
+    period per call, so the session time runs on across passes.
+*/
+static void benchFrame(const std::vector<FrameParams> &params, CRGB *leds) {
+    static TemporalDither dither;
+    static PowerLimiter limiter;
+    OscillatorBank bank;
+    bank.init();
+    uint64_t us = (uint64_t)(RAMP_IN_SECONDS * 1e6f);
+
+    using RenderFn = void (*)(const FrameParams &, CRGB *);
+    const RenderFn paths[2] = {renderFrameFloat, renderFrameQ15};
+    const char *const names[2] = {FLOAT_BACKEND, "q15"};
+    for (int p = 0; p < 2; ++p) {
+        emit("frame", names[p], 1, timeKernel([&](const FrameParams &) {
+            FrameParams fp = computeFrameParams(bank, us);
+            us += FRAME_PERIOD_US;
+            paths[p](fp, leds);
+            uint32_t master = outputMaster(fp.master);
+            limiter.update(dither.apply(outputCurve(), leds, limiter.limit(master)));
+        }, params));
+    }
+}
+
+static void runBenchmarks(int frames) {
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        consolePrintf("session program: %s\n", activeProgram().error);
+        return;
+    }
+    OscillatorBank bank;
+    bank.init();
+    uint64_t startUs = (uint64_t)(RAMP_IN_SECONDS * 1e6f);
+    std::vector<FrameParams> params(frames);
+    for (int f = 0; f < frames; ++f) params[f] = computeFrameParams(bank, startUs + (uint64_t)f * FRAME_PERIOD_US);
+
+    static CRGB leds[NUM_LEDS];
+    benchMasks(params);
+    benchColor(params);
+    benchPulse(params);
+    benchEcho(params, leds);
+    benchFrame(params, leds);
+}
+
+/* ---------------- MAIN ---------------- */
+
+#if defined(ARDUINO)
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+    runBenchmarks(200);
+}
+
+void loop() {
+    delay(1000);
+}
+
+#else
+
+int main(int argc, char **argv) {
+    int frames = (argc > 1) ? atoi(argv[1]) : 500;
+    if (frames < 1) frames = 1;
+    runBenchmarks(frames);
+    return 0;
+}
+
+#endif
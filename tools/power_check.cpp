@@ -0,0 +1,400 @@
+/*
+    ================================================================
+                 POWER LIMITER CHECK (host, or any target)
+    ================================================================
+
+    Drives synthetic worst-case frames, and a stretch of the real
+    session, through the output pass (temporal dither, gamma.h curve) at
+    a supply budget below what they draw. Each scenario runs three ways:
+
+      none     unity gain, what the frames would draw
+      clip     every frame scaled down on its own to just fit the budget
+               (an ideal per-frame clipper, computed from `none`)
+      limiter  PowerLimiter (power.h), as ledOutputShow() runs it
+
+    The synthetic frames are at master level 1: white sine and square
+    flicker, both eyes at different rates, a black-to-white step and
+    random bytes. The budget is a fraction of all-white (-b, default
+    50 %); the session gets the same fraction of its own peak, 200 s in.
+
+    Reported per scenario and path, after the first SETTLE_SECONDS:
+
+        peak      highest frame current, mA
+        over      frames above the budget; for the limiter over the
+                  whole run, since its onset is the interesting part
+        max over  the worst of those, % above the budget
+        shape     waveform distortion: per 1 s block, the RMS residual
+                  of the drive current after a least-squares fit of a
+                  gain ramp to `none`, relative to its AC RMS
+        thd       harmonics 2-5 against the fundamental, periodic
+                  scenarios only
+
+    The run fails unless, in every steady scenario (constant envelope),
+    the limiter stays within the budget after settling, lets at most
+    MAX_ONSET_FRAMES over it at onset, keeps shape distortion under 1 %
+    and THD within 0.5 points of `none`. Noise and the session have no
+    steady peak to hold; after settling they must stay within
+    POWER_HEADROOM above the budget. The session must also keep its
+    shape distortion under 4 %: the gain may step at a new peak, but
+    must hold through the breathing and the L/R beat rather than level
+    them. In every scenario the estimate must match the current of the
+    bytes actually sent, over the run, to within 0.5 %. Finally the per-frame cost of the drive totals and the
+    limiter, against a copy of the output pass without them.
+
+    Usage: power_check [-b budget-percent] [-s seconds]
+*/
+
+#include <FastLED.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "config.h"
+#include "cycles.h"
+#include "dither.h"
+#include "gamma.h"
+#include "power.h"
+#include "presentation.h"
+#include "render.h"
+#include "session_program.h"
+#include "topology.h"
+
+constexpr float  SETTLE_SECONDS    = 2.0f;
+constexpr float  SESSION_START_S   = 200.0f;
+constexpr float  OVER_TOLERANCE    = 1e-4f;   // float rounding of the estimate
+constexpr int    MAX_ONSET_FRAMES  = 2;
+constexpr double MAX_SHAPE_PCT     = 1.0;
+constexpr double MAX_AGC_SHAPE_PCT = 4.0;   // levelling the breathing: 6-9 %
+constexpr double MAX_THD_RISE_PCT  = 0.5;
+constexpr double MAX_ESTIMATE_PCT  = 0.5;
+constexpr int    FRAMES_PER_SECOND = (int)(1000000 / FRAME_PERIOD_US);
+
+enum Path { PATH_NONE, PATH_CLIP, PATH_LIMITER, PATH_COUNT };
+static const char *const PATH_NAMES[PATH_COUNT] = {"none", "clip", "limiter"};
+
+/* ---------------- SCENARIOS ---------------- */
+
+struct Scenario {
+    const char *name;
+    float       hz;       // fundamental, 0 = not periodic
+    bool        steady;   // constant envelope: the limiter must not change the shape
+    void (*fill)(CRGB *leds, int k);
+};
+
+static float frameSeconds(int k) {
+    return (float)k * FRAME_PERIOD_US * 1e-6f;
+}
+
+// 0..255, starting at 0 so the load rises from black
+static uint8_t sineByte(float hz, int k) {
+    return (uint8_t)(127.5f - 127.5f * cosf(2.0f * (float)M_PI * hz * frameSeconds(k)) + 0.5f);
+}
+
+static void fillWhiteSine(CRGB *leds, int k) {
+    uint8_t v = sineByte(6.0f, k);
+    fill_solid(leds, NUM_LEDS, CRGB(v, v, v));
+}
+
+static void fillEyes(CRGB *leds, int k) {
+    const Topology &topo = topology();
+    uint8_t v[2] = {sineByte(4.0f, k), sineByte(8.0f, k)};
+    for (int i = 0; i < NUM_LEDS; ++i) {
+        uint8_t e = v[topo.eye[topo.rankOf[i]]];
+        leds[i] = CRGB(e, e, e);
+    }
+}
+
+static void fillSquare(CRGB *leds, int k) {
+    bool on = fmodf(frameSeconds(k) * 5.0f, 1.0f) >= 0.5f;
+    fill_solid(leds, NUM_LEDS, on ? CRGB::White : CRGB::Black);
+}
+
+static void fillStep(CRGB *leds, int k) {
+    fill_solid(leds, NUM_LEDS, frameSeconds(k) < 1.0f ? CRGB::Black : CRGB::White);
+}
+
+static void fillNoise(CRGB *leds, int k) {
+    uint32_t x = 0x9E3779B9u * (uint32_t)(k + 1);
+    uint8_t *bytes = (uint8_t *)leds;
+    for (int i = 0; i < NUM_LEDS * 3; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        bytes[i] = (uint8_t)x;
+    }
+}
+
+static const Scenario SYNTHETIC[] = {
+    {"white 6 Hz",      6.0f, true,  fillWhiteSine},
+    {"eyes 4 + 8 Hz",   0.0f, true,  fillEyes},
+    {"white square 5 Hz", 5.0f, true,  fillSquare},
+    {"step to white",   0.0f, true,  fillStep},
+    {"noise",           0.0f, false, fillNoise},
+};
+
+/* ---------------- RUN ---------------- */
+
+struct Trace {
+    std::vector<float> ma[PATH_COUNT];   // estimate per frame
+    double             sentMa = 0.0;     // limiter path, from the bytes on the wire (summed)
+    double             estMa = 0.0;      // limiter path, estimate (summed)
+};
+
+// Current of the bytes as sent, mA
+static float sentCurrentMa(const CRGB *leds) {
+    double sum[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < NUM_LEDS; ++i) {
+        sum[0] += leds[i].r;
+        sum[1] += leds[i].g;
+        sum[2] += leds[i].b;
+    }
+    double ma = LED_IDLE_MA * NUM_LEDS;
+    for (int c = 0; c < 3; ++c) ma += LED_CHANNEL_MA[c] * sum[c] / 255.0;
+    return (float)ma;
+}
+
+/*
+    Send `frames` frames from `source` through both real paths; each
+    frame is rendered into `leds` and drawn at master `master[k]`.
+*/
+template <typename Source>
+static Trace runScenario(Source source, const std::vector<uint32_t> &master, uint32_t budgetMa) {
+    static TemporalDither dither[2];
+    static CRGB frame[NUM_LEDS], sent[NUM_LEDS];
+    dither[0].reset();
+    dither[1].reset();
+    PowerLimiter limiter;
+    limiter.reset(budgetMa, activeProgram().holdSeconds);
+    const OutputCurve &curve = outputCurve();
+    const float idle = LED_IDLE_MA * NUM_LEDS;
+
+    Trace tr;
+    for (size_t k = 0; k < master.size(); ++k) {
+        source(frame, (int)k);
+
+        memcpy(sent, frame, sizeof(frame));
+        float none = estimateCurrentMa(dither[0].apply(curve, sent, master[k]));
+        tr.ma[PATH_NONE].push_back(none);
+        float fit = (none - idle > 0.0f) ? std::min(1.0f, ((float)budgetMa - idle) / (none - idle)) : 1.0f;
+        tr.ma[PATH_CLIP].push_back(idle + (none - idle) * fit);
+
+        memcpy(sent, frame, sizeof(frame));
+        limiter.update(dither[1].apply(curve, sent, limiter.limit(master[k])));
+        tr.ma[PATH_LIMITER].push_back(limiter.lastMa);
+        tr.sentMa += sentCurrentMa(sent);
+        tr.estMa += limiter.lastMa;
+    }
+    return tr;
+}
+
+/* ---------------- METRICS ---------------- */
+
+/*
+    Distortion of `y` against `x` in %. Per block of one second, `y` is
+    fitted as (a + b·t)·x by least squares, so a gain that drifts within
+    the block counts as level, not as shape.
+*/
+static double shapePct(const std::vector<float> &x, const std::vector<float> &y, size_t from, float idle) {
+    double residual = 0.0, ac = 0.0;
+    for (size_t b = from; b + FRAMES_PER_SECOND <= x.size(); b += FRAMES_PER_SECOND) {
+        // Normal equations for a, b over u = x, v = t·x
+        double uu = 0.0, uv = 0.0, vv = 0.0, uy = 0.0, vy = 0.0, mean = 0.0;
+        for (size_t i = b; i < b + FRAMES_PER_SECOND; ++i) {
+            double t = ((double)(i - b) - 0.5 * FRAMES_PER_SECOND) / FRAMES_PER_SECOND;
+            double u = x[i] - idle, v = t * u, w = y[i] - idle;
+            uu += u * u;
+            uv += u * v;
+            vv += v * v;
+            uy += u * w;
+            vy += v * w;
+            mean += u;
+        }
+        double det = uu * vv - uv * uv;
+        if (uu <= 0.0 || det <= 1e-9 * uu * vv) continue;
+        double ga = (uy * vv - vy * uv) / det, gb = (vy * uu - uy * uv) / det;
+        mean /= FRAMES_PER_SECOND;
+        for (size_t i = b; i < b + FRAMES_PER_SECOND; ++i) {
+            double t = ((double)(i - b) - 0.5 * FRAMES_PER_SECOND) / FRAMES_PER_SECOND;
+            double u = x[i] - idle, g = ga + gb * t, e = (y[i] - idle) - g * u;
+            residual += e * e;
+            ac += g * g * (u - mean) * (u - mean);
+        }
+    }
+    return ac > 0.0 ? 100.0 * sqrt(residual / ac) : 0.0;
+}
+
+// Harmonics 2-5 of `hz` against the fundamental in %, over whole seconds from `from`
+static double thdPct(const std::vector<float> &x, size_t from, float hz) {
+    size_t n = (x.size() - from) / FRAMES_PER_SECOND * FRAMES_PER_SECOND;
+    double power[6] = {};
+    for (int h = 1; h <= 5; ++h) {
+        double re = 0.0, im = 0.0, w = 2.0 * M_PI * hz * h / FRAMES_PER_SECOND;
+        for (size_t i = 0; i < n; ++i) {
+            re += x[from + i] * cos(w * (double)i);
+            im += x[from + i] * sin(w * (double)i);
+        }
+        power[h] = re * re + im * im;
+    }
+    double harmonics = power[2] + power[3] + power[4] + power[5];
+    return power[1] > 0.0 ? 100.0 * sqrt(harmonics / power[1]) : 0.0;
+}
+
+/*
+    Print one scenario and apply the gates. The limiter's `over` counts
+    the whole run, the other paths' only after settling. `envelope`: a
+    changing load whose slow modulation the limiter must not level.
+*/
+static bool report(const char *name, float hz, bool steady, bool envelope, const Trace &tr, uint32_t budgetMa) {
+    const float idle = LED_IDLE_MA * NUM_LEDS;
+    const size_t settle = (size_t)(SETTLE_SECONDS * FRAMES_PER_SECOND);
+    const float budget = (float)budgetMa * (1.0f + OVER_TOLERANCE);
+    bool ok = true;
+    double thd[PATH_COUNT] = {};
+
+    for (int p = 0; p < PATH_COUNT; ++p) {
+        const std::vector<float> &ma = tr.ma[p];
+        float peak = 0.0f, worst = 0.0f, settledWorst = 0.0f;
+        int over = 0, settledOver = 0;
+        for (size_t k = 0; k < ma.size(); ++k) {
+            if (k >= settle) peak = std::max(peak, ma[k]);
+            if (ma[k] > budget) {
+                over++;
+                if (k >= settle) {
+                    settledOver++;
+                    settledWorst = std::max(settledWorst, ma[k]);
+                }
+                if (p == PATH_LIMITER || k >= settle) worst = std::max(worst, ma[k]);
+            }
+        }
+        double shape = shapePct(tr.ma[PATH_NONE], ma, settle, idle);
+        double worstPct = worst > 0.0f ? 100.0 * (worst / (float)budgetMa - 1.0f) : 0.0;
+        printf("%-16s %-8s %8.0f %6d %7.1f%% %7.2f%%", p == 0 ? name : "", PATH_NAMES[p], peak,
+               p == PATH_LIMITER ? over : settledOver, worstPct, shape);
+        if (hz > 0.0f) {
+            thd[p] = thdPct(ma, settle, hz);
+            printf(" %7.2f%%", thd[p]);
+        }
+        printf("\n");
+        if (p == PATH_LIMITER) {
+            // Steady frames stay under the budget; a changing load within the headroom
+            if (steady) ok = settledOver == 0 && over <= MAX_ONSET_FRAMES && shape <= MAX_SHAPE_PCT;
+            else        ok = settledWorst <= (float)budgetMa * (1.0f + POWER_HEADROOM) &&
+                             (!envelope || shape <= MAX_AGC_SHAPE_PCT);
+        }
+    }
+    if (hz > 0.0f && thd[PATH_LIMITER] > thd[PATH_NONE] + MAX_THD_RISE_PCT) ok = false;
+
+    double estErr = 100.0 * fabs(tr.estMa - tr.sentMa) / tr.sentMa;
+    if (estErr > MAX_ESTIMATE_PCT) ok = false;
+    printf("%-16s estimate vs bytes sent %.3f%%: %s\n", "", estErr, ok ? "pass" : "FAIL");
+    return ok;
+}
+
+/* ---------------- COST ---------------- */
+
+// TemporalDither::apply() without the drive totals, for the cost comparison
+static void applyNoLoad(TemporalDither &d, const OutputCurve &curve, CRGB *leds, uint32_t master) {
+    uint8_t *bytes = (uint8_t *)leds;
+    uint8_t *res = d.residual;
+    for (int i = 0; i < NUM_LEDS; ++i, bytes += 3, res += 3) {
+        for (int c = 0; c < 3; ++c) {
+            uint16_t acc = res[c] + (uint16_t)((curve.level[c][bytes[c]] * master) >> 16);
+            bytes[c] = (uint8_t)(acc >> 8);
+            res[c] = (uint8_t)acc;
+        }
+    }
+}
+
+// Median cycles per frame of the pass without (0) and with (1) totals and limiter
+static void passCycles(uint32_t out[2]) {
+    static TemporalDither dither;
+    static CRGB frame[NUM_LEDS];
+    PowerLimiter limiter;
+    std::vector<uint32_t> cycles[2];
+    for (int f = 0; f < 500; ++f) {
+        for (int v = 0; v < 2; ++v) {
+            fillNoise(frame, f);
+            uint32_t c0 = readCycleCounter();
+            if (v == 0) {
+                applyNoLoad(dither, outputCurve(), frame, OUTPUT_MASTER_FULL);
+            } else {
+                limiter.update(dither.apply(outputCurve(), frame, limiter.limit(OUTPUT_MASTER_FULL)));
+            }
+            cycles[v].push_back(readCycleCounter() - c0);
+        }
+    }
+    for (int v = 0; v < 2; ++v) {
+        std::nth_element(cycles[v].begin(), cycles[v].begin() + cycles[v].size() / 2, cycles[v].end());
+        out[v] = cycles[v][cycles[v].size() / 2];
+    }
+}
+
+/* ---------------- MAIN ---------------- */
+
+static void usage() {
+    fprintf(stderr, "usage: power_check [-b budget-percent] [-s seconds]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    double budgetPct = 50.0, seconds = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        if      (strcmp(argv[i], "-b") == 0) budgetPct = atof(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0) seconds = atof(argv[++i]);
+        else usage();
+    }
+    if (budgetPct <= 0.0 || budgetPct >= 100.0 || seconds < 2.0 * SETTLE_SECONDS) usage();
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        fprintf(stderr, "session program: %s\n", activeProgram().error);
+        return 1;
+    }
+
+    const int frames = (int)(seconds * FRAMES_PER_SECOND);
+    const uint32_t budget = (uint32_t)(fullWhiteCurrentMa() * budgetPct / 100.0);
+    printf("%s, NUM_LEDS %d, full white %.0f mA, budget %u mA (%.0f %%), %d frames\n\n", topology().name,
+           NUM_LEDS, fullWhiteCurrentMa(), (unsigned)budget, budgetPct, frames);
+    printf("%-16s %-8s %8s %6s %8s %8s %8s\n", "scenario", "path", "peak mA", "over", "max over", "shape",
+           "thd");
+
+    bool ok = true;
+    std::vector<uint32_t> full((size_t)frames, OUTPUT_MASTER_FULL);
+    for (const Scenario &s : SYNTHETIC) {
+        ok = report(s.name, s.hz, s.steady, false, runScenario(s.fill, full, budget), budget) && ok;
+    }
+
+    // The session as rendered, budget against its own unlimited peak
+    static std::vector<CRGB> rendered((size_t)frames * NUM_LEDS);
+    std::vector<uint32_t> master((size_t)frames);
+    OscillatorBank bank;
+    bank.init();
+    uint64_t startUs = (uint64_t)(SESSION_START_S * 1e6f);
+    bank.seek(startUs);
+    for (int k = 0; k < frames; ++k) {
+        FrameParams fp = computeFrameParams(bank, startUs + (uint64_t)k * FRAME_PERIOD_US);
+        renderFrame(fp, &rendered[(size_t)k * NUM_LEDS]);
+        master[k] = outputMaster(fp.master);
+    }
+    auto session = [&](CRGB *leds, int k) {
+        memcpy(leds, &rendered[(size_t)k * NUM_LEDS], NUM_LEDS * sizeof(CRGB));
+    };
+    Trace probe = runScenario(session, master, 0);
+    float sessionPeak = *std::max_element(probe.ma[PATH_NONE].begin(), probe.ma[PATH_NONE].end());
+    uint32_t sessionBudget = (uint32_t)(sessionPeak * budgetPct / 100.0);
+    printf("\nsession %.0f-%.0f s: peak %.0f mA unlimited, budget %u mA\n", SESSION_START_S,
+           SESSION_START_S + seconds, sessionPeak, (unsigned)sessionBudget);
+    ok = report("session", 0.0f, false, true, runScenario(session, master, sessionBudget), sessionBudget) && ok;
+
+    uint32_t cycles[2];
+    passCycles(cycles);
+    double perUs = (double)cycleCounterHz() * 1e-6;
+    printf("\noutput pass: %u cycles/frame, with drive totals and limiter %u (+%.1f%%, %.2f us)\n",
+           (unsigned)cycles[0], (unsigned)cycles[1],
+           100.0 * ((double)cycles[1] - cycles[0]) / cycles[0], ((double)cycles[1] - cycles[0]) / perUs);
+    printf("%s\n", ok ? "pass" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+/*
+    ================================================================
+                   SESSION PROGRAM CHECKER (host)
+    ================================================================
+
+    Compiles session programs exactly as the firmware does at boot and
+    evaluates them frame by frame over the whole session:
+
+      - the compiled record table (start, eye frequencies, chirp, level)
+      - every frame's eye frequencies stay inside MIN_FREQ_HZ..MAX_FREQ_HZ
+      - phase is continuous: no oscillator's per-frame phase step exceeds
+        its fastest frequency times the frame period (for the eyes,
+        MAX_FREQ_HZ * FRAME_PERIOD_US), and outside a
+        SWEEP_HOLD step the step changes by no more than the steepest
+        chirp allows (chirp * T^2), i.e. frequency is continuous too
+      - seeking an independent bank to sampled frames gives bit-identical
+        phases to advancing frame by frame
+      - with -t, a timeline of frequency, level and mode every N seconds
+
+    Exits non-zero if any program fails to compile or any check fails.
+
+    Usage: program_check [-p program] [-t seconds]
+      -p  check only this SESSION_PROGRAMS index (default: all)
+      -t  print the evaluated timeline at this interval
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "render.h"
+#include "session_program.h"
+
+static double hzOf(uint64_t incPerUs) {
+    return (double)incPerUs / DDS_TURNS_PER_US_AT_1HZ;
+}
+
+static void printRecords(const CompiledProgram &prog) {
+    printf("  %3s %8s %8s %8s %12s %12s %6s %6s %5s\n",
+           "seg", "start s", "L Hz", "R Hz", "L chirp Hz/s", "R chirp Hz/s", "level", "mod", "mode");
+    for (int i = 0; i < prog.count; ++i) {
+        const ProgramRecord &r = prog.records[i];
+        char mode[8];
+        if (r.mandalaMode == MANDALA_CYCLE) strcpy(mode, "cycle");
+        else snprintf(mode, sizeof(mode), "%d", r.mandalaMode);
+        printf("  %3u %8.1f %8.3f %8.3f %12.6f %12.6f %6.2f %6s %5s%s\n",
+               (unsigned)r.segment, (double)r.startUs * 1e-6,
+               hzOf(r.incPerUs[OSC_LEFT]), hzOf(r.incPerUs[OSC_RIGHT]),
+               (double)r.chirpPerUs[OSC_LEFT] * 1e6 / DDS_TURNS_PER_US_AT_1HZ,
+               (double)r.chirpPerUs[OSC_RIGHT] * 1e6 / DDS_TURNS_PER_US_AT_1HZ,
+               r.levelTo, r.modulation == MOD_SINE ? "sine" : "pulse", mode,
+               (i + 1 == prog.count) ? "  (end)" : "");
+    }
+}
+
+static bool checkProgram(int index, double timelineStep) {
+    if (!loadSessionProgram(index)) {
+        const CompiledProgram &prog = activeProgram();
+        printf("program %d: REJECTED: %s (segment %d)\n", index, prog.error, prog.errorSegment);
+        return false;
+    }
+    const CompiledProgram &prog = activeProgram();
+    printf("program %d: %s, %u segments, %.1f s\n", index, prog.name,
+           (unsigned)prog.source->count, prog.seconds);
+    printRecords(prog);
+
+    OscillatorBank bank;
+    bank.init(prog);
+
+    // Phase-step bounds from the compiled table
+    uint64_t maxInc[OSC_COUNT] = {};
+    uint64_t maxChirp = 0;
+    for (int i = 0; i < prog.count; ++i) {
+        const ProgramRecord &r = prog.records[i];
+        uint64_t span = (i + 1 < prog.count) ? prog.records[i + 1].startUs - r.startUs : 0;
+        for (int o = 0; o < OSC_COUNT; ++o) {
+            uint64_t chirp = (uint64_t)(r.chirpPerUs[o] < 0 ? -r.chirpPerUs[o] : r.chirpPerUs[o]);
+            uint64_t peak = r.incPerUs[o] + (r.chirpPerUs[o] > 0 ? chirp * span : 0);
+            if (peak > maxInc[o]) maxInc[o] = peak;
+            if (chirp > maxChirp) maxChirp = chirp;
+        }
+    }
+    const uint64_t T = FRAME_PERIOD_US;
+    uint64_t prevPhase[OSC_COUNT] = {}, prevStep[OSC_COUNT] = {};
+    uint16_t prevCursor = bank.cursor;
+    int holdStepFrames = 0;
+    const double eyeStepBound = MAX_FREQ_HZ * FRAME_PERIOD_US * 1e-6;
+    double maxEyeStep = 0.0, maxJerkTurns = 0.0;
+    uint64_t stepFailures = 0;
+
+    uint64_t endUs = (uint64_t)((sessionEndSeconds() + FADE_OUT_SECONDS) * 1e6);
+    uint64_t frames = endUs / FRAME_PERIOD_US;
+    uint64_t nextTimelineUs = 0;
+    uint64_t seekChecks = 0, seekFailures = 0, rangeFailures = 0;
+    double minHz = 1e9, maxHz = 0.0;
+
+    for (uint64_t k = 0; k <= frames; ++k) {
+        uint64_t us = k * FRAME_PERIOD_US;
+        FrameParams fp = computeFrameParams(bank, us);
+
+        // A SWEEP_HOLD record changes frequency on purpose: skip the
+        // frequency-continuity check for the two frames that straddle it
+        if (bank.cursor != prevCursor) {
+            for (uint16_t r = prevCursor + 1; r <= bank.cursor; ++r) {
+                uint16_t seg = prog.records[r].segment;
+                if (seg < prog.source->count && prog.source->segments[seg].sweep == SWEEP_HOLD) holdStepFrames = 2;
+            }
+            prevCursor = bank.cursor;
+        }
+        for (int o = 0; o < OSC_COUNT && k > 0; ++o) {
+            uint64_t step = bank.osc[o].phase - prevPhase[o];
+            double stepTurns = (double)step / 18446744073709551616.0;
+            double bound = (double)maxInc[o] * (double)T / 18446744073709551616.0;
+            if (o == OSC_LEFT || o == OSC_RIGHT) {
+                if (stepTurns > maxEyeStep) maxEyeStep = stepTurns;
+                if (stepTurns > eyeStepBound * (1.0 + 1e-6)) stepFailures++;
+            }
+            if (stepTurns > bound * (1.0 + 1e-9)) stepFailures++;
+
+            if (k > 1 && holdStepFrames == 0) {
+                int64_t jerk = (int64_t)(step - prevStep[o]);
+                uint64_t mag = (uint64_t)(jerk < 0 ? -jerk : jerk);
+                double jerkTurns = (double)mag / 18446744073709551616.0;
+                if (jerkTurns > maxJerkTurns) maxJerkTurns = jerkTurns;
+                if (mag > maxChirp * T * T + T) stepFailures++;
+            }
+            prevStep[o] = step;
+        }
+        for (int o = 0; o < OSC_COUNT; ++o) prevPhase[o] = bank.osc[o].phase;
+        if (holdStepFrames > 0) holdStepFrames--;
+
+        for (int eye = OSC_LEFT; eye <= OSC_RIGHT; ++eye) {
+            double hz = hzOf(bank.osc[eye].incPerUs);
+            if (hz < minHz) minHz = hz;
+            if (hz > maxHz) maxHz = hz;
+            // Allow for the increment quantisation of a chirp
+            if (hz < MIN_FREQ_HZ - 1e-6 || hz > MAX_FREQ_HZ + 1e-6) rangeFailures++;
+        }
+
+        // Every 997th frame, and every segment start, from a fresh bank
+        bool boundary = us == bank.segment().startUs;
+        if (k % 997 == 0 || boundary) {
+            OscillatorBank fresh;
+            fresh.init(prog);
+            fresh.seek(us);
+            seekChecks++;
+            for (int o = 0; o < OSC_COUNT; ++o) {
+                if (fresh.osc[o].phase != bank.osc[o].phase) {
+                    seekFailures++;
+                    break;
+                }
+            }
+        }
+
+        if (timelineStep > 0.0 && us >= nextTimelineUs) {
+            printf("  t %7.1f s  L %.4f Hz  R %.4f Hz  level %.3f  mode %d  master %.4f\n",
+                   fp.t, hzOf(bank.osc[OSC_LEFT].incPerUs), hzOf(bank.osc[OSC_RIGHT].incPerUs),
+                   fp.rampMul, fp.mandalaMode, fp.master);
+            nextTimelineUs += (uint64_t)(timelineStep * 1e6);
+        }
+    }
+
+    bool ok = seekFailures == 0 && rangeFailures == 0 && stepFailures == 0;
+    printf("  %llu frames, eye range %.4f..%.4f Hz, %llu out-of-range samples\n",
+           (unsigned long long)(frames + 1), minHz, maxHz, (unsigned long long)rangeFailures);
+    printf("  eye phase step max %.6f turns/frame (bound %.6f), step change max %.3e turns "
+           "(bound %.3e), %llu violations\n",
+           maxEyeStep, eyeStepBound, maxJerkTurns,
+           (double)(maxChirp * T * T + T) / 18446744073709551616.0, (unsigned long long)stepFailures);
+    printf("  %llu seek checks, %llu mismatches: %s\n", (unsigned long long)seekChecks,
+           (unsigned long long)seekFailures, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    int only = -1;
+    double timelineStep = 0.0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) only = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) timelineStep = atof(argv[++i]);
+        else {
+            fprintf(stderr, "usage: program_check [-p program] [-t seconds]\n");
+            return 2;
+        }
+    }
+
+    bool ok = true;
+    for (int p = 0; p < SESSION_PROGRAM_COUNT; ++p) {
+        if (only >= 0 && p != only) continue;
+        ok = checkProgram(p, timelineStep) && ok;
+    }
+    if (only >= SESSION_PROGRAM_COUNT) ok = checkProgram(only, timelineStep);
+    return ok ? 0 : 1;
+}
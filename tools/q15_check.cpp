@@ -0,0 +1,94 @@
+/*
+    ================================================================
+                 FLOAT vs Q15 RENDER PATH CHECK (host)
+    ================================================================
+
+    Renders each session program, ramp-in through fade-out, with both
+    render paths at the same frame parameters and compares the LED
+    buffers renderFrame() fills (before the output curve and master
+    level) channel by channel. Frames are sampled every STEP_US, which
+    is not a multiple of the frame period, so the sweep lands on
+    phases a 100 FPS run never hits.
+
+    Fails if any channel of any LED differs by more than
+    Q15_TOLERANCE_LSB, the bound render.h promises. Prints the worst
+    difference and a histogram per channel.
+
+    Usage: q15_check [-p program]
+*/
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "render.h"
+#include "session_program.h"
+
+constexpr int      Q15_TOLERANCE_LSB = 2;
+constexpr uint64_t STEP_US = 7900;
+
+static const char *const CHANNELS = "RGB";
+
+static bool checkProgram(int program) {
+    if (!loadSessionProgram(program)) {
+        printf("program %d: %s\n", program, activeProgram().error);
+        return false;
+    }
+    OscillatorBank bank;
+    bank.init();
+    uint64_t endUs = (uint64_t)((sessionEndSeconds() + FADE_OUT_SECONDS) * 1e6f);
+
+    static CRGB fl[NUM_LEDS], q[NUM_LEDS];
+    uint64_t hist[3][Q15_TOLERANCE_LSB + 2] = {};   // last bucket: over tolerance
+    int worst[3] = {};
+    uint64_t frames = 0, worstAtUs = 0;
+    for (uint64_t us = 0; us < endUs; us += STEP_US, ++frames) {
+        FrameParams fp = computeFrameParams(bank, us);
+        renderFrameFloat(fp, fl);
+        renderFrameQ15(fp, q);
+        for (int i = 0; i < NUM_LEDS; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                int d = abs((int)fl[i].raw[c] - (int)q[i].raw[c]);
+                hist[c][d > Q15_TOLERANCE_LSB ? Q15_TOLERANCE_LSB + 1 : d]++;
+                if (d > worst[c]) {
+                    worst[c] = d;
+                    worstAtUs = us;
+                }
+            }
+        }
+    }
+
+    bool ok = true;
+    printf("program %d: %llu frames x %d LEDs, %s trig, tolerance %d LSB\n", program,
+           (unsigned long long)frames, NUM_LEDS, TRIG_USE_LUT ? "LUT" : "float", Q15_TOLERANCE_LSB);
+    for (int c = 0; c < 3; ++c) {
+        printf("  %c  max %d LSB  ", CHANNELS[c], worst[c]);
+        for (int d = 0; d <= Q15_TOLERANCE_LSB; ++d) printf("  %d: %llu", d, (unsigned long long)hist[c][d]);
+        printf("  over: %llu\n", (unsigned long long)hist[c][Q15_TOLERANCE_LSB + 1]);
+        ok = ok && worst[c] <= Q15_TOLERANCE_LSB;
+    }
+    if (!ok) printf("  FAIL: worst difference at %.4f s\n", (double)worstAtUs * 1e-6);
+    return ok;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: q15_check [-p program]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    int only = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        if (strcmp(argv[i], "-p") == 0) only = atoi(argv[++i]);
+        else usage();
+    }
+    bool ok = true;
+    for (int p = 0; p < SESSION_PROGRAM_COUNT; ++p) {
+        if (only < 0 || p == only) ok = checkProgram(p) && ok;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
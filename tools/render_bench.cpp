@@ -0,0 +1,181 @@
+/*
+    ================================================================
+                 RENDER LOOP BENCHMARK (host, or any target)
+    ================================================================
+
+    Per-frame cycles of the render path for each mandala mode at this
+    build's NUM_LEDS (render_bench, render_bench_300, render_bench_3000
+    envs):
+
+      legacy   the body loop before mode policies: an if/else on the mode
+               and the blended colour recomputed for every LED (kept
+               here as the reference)
+      float    renderFrameFloat(): one templated body loop per mode,
+               picked once per frame, invariants hoisted
+      q15      renderFrameQ15(), same structure
+
+    Frame parameters come from the session program at successive frames
+    after the ramp-in, with the mode forced. On the spiral strip
+    (LED_LAYOUT 0) legacy and float must produce identical frames; the
+    run fails otherwise. Build with
+    -DHOT_PATH_PROFILER=0 so profiler stamps do not skew the numbers.
+
+    Usage: render_bench [frames per mode]
+*/
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "config.h"
+#include "cycles.h"
+#include "render.h"
+#include "session_program.h"
+#include "topology.h"
+
+/* ---------------- LEGACY REFERENCE ---------------- */
+
+// Position along the strip, as the masks computed it before the topology table
+static float stripPos(int i) {
+    return (float)i / (float)NUM_LEDS;
+}
+
+static void renderFrameLegacy(const FrameParams &fp, CRGB *leds) {
+    const uint16_t *spiralOrder = topology().led;
+    const float finalL = fp.finalL;
+    const float finalR = fp.finalR;
+    const int mandalaMode = fp.mandalaMode;
+    const float baseL = phase01(fp.phaseLeft);
+    const float baseR = phase01(fp.phaseRight);
+
+    for (int i = 0; i < NUM_LEDS; ++i) leds[i] = CRGB::Black;
+
+    for (int i = 0; i < 3; ++i) {
+        float amp = finalL * spiralMask(stripPos(i), phase01(fp.phaseSpiralLeft));
+        leds[spiralOrder[i]] = CRGB(safeClampInt(LEFT_COLOR.r * amp), safeClampInt(LEFT_COLOR.g * amp),
+                                    safeClampInt(LEFT_COLOR.b * amp));
+    }
+    for (int i = NUM_LEDS - 3; i < NUM_LEDS; ++i) {
+        float amp = finalR * spiralMask(stripPos(i), phase01(fp.phaseSpiralRight));
+        leds[spiralOrder[i]] = CRGB(safeClampInt(RIGHT_COLOR.r * amp), safeClampInt(RIGHT_COLOR.g * amp),
+                                    safeClampInt(RIGHT_COLOR.b * amp));
+    }
+    float centerAmp = clamp01((finalL + finalR) * 0.5f);
+    leds[spiralOrder[0]] = CRGB(safeClampInt(CENTER_COLOR.r * centerAmp), safeClampInt(CENTER_COLOR.g * centerAmp),
+                                safeClampInt(CENTER_COLOR.b * centerAmp));
+    leds[spiralOrder[1]] = leds[spiralOrder[0]];
+
+    for (int pos = 2; pos < NUM_LEDS - 2; ++pos) {
+        float mask;
+        if      (mandalaMode == 0) mask = radialMask(stripPos(pos), phase01(fp.phaseCarrier), 8);
+        else if (mandalaMode == 1) mask = spiralMask(stripPos(pos), phase01(fp.phaseSpiralBody));
+        else                       mask = interferenceMask(stripPos(pos), baseL, baseR);
+        mask = clamp01(mask);
+
+        float stereoMix = (pos < NUM_LEDS / 2) ? 0.8f : 0.2f;
+        float mixedAmp = clamp01(mask * (stereoMix * finalL + (1.0f - stereoMix) * finalR));
+        CRGB blended = mixColor(CENTER_COLOR, mixColor(LEFT_COLOR, RIGHT_COLOR, 0.5f), 0.6f);
+
+        int r = blended.r * mixedAmp;
+        int g = blended.g * mixedAmp;
+        int b = blended.b * mixedAmp;
+        leds[spiralOrder[pos]] = CRGB(safeClampInt(r), safeClampInt(g), safeClampInt(b));
+
+        int echoPos = pos + REFLECTION_OFFSET;
+        if (echoPos < NUM_LEDS) {
+            CRGB &e = leds[spiralOrder[echoPos]];
+            e.r = qadd8(e.r, (uint8_t)(r * REFLECTION_DECAY));
+            e.g = qadd8(e.g, (uint8_t)(g * REFLECTION_DECAY));
+            e.b = qadd8(e.b, (uint8_t)(b * REFLECTION_DECAY));
+        }
+    }
+}
+
+/* ---------------- HARNESS ---------------- */
+
+using RenderFn = void (*)(const FrameParams &, CRGB *);
+
+struct Backend {
+    const char *name;
+    RenderFn    render;
+};
+
+static const Backend BACKENDS[] = {
+    {"legacy", renderFrameLegacy},
+    {"float",  renderFrameFloat},
+    {"q15",    renderFrameQ15},
+};
+constexpr int BACKEND_COUNT = sizeof(BACKENDS) / sizeof(BACKENDS[0]);
+
+static const char *const MODE_NAMES[3] = {"radial", "spiral", "interference"};
+
+// Median cycles per frame over `params`, best of three passes
+static uint32_t timeBackend(RenderFn render, const std::vector<FrameParams> &params, CRGB *leds) {
+    std::vector<uint32_t> cycles(params.size());
+    uint32_t best = UINT32_MAX;
+    for (int pass = 0; pass < 3; ++pass) {
+        for (size_t f = 0; f < params.size(); ++f) {
+            uint32_t c0 = readCycleCounter();
+            render(params[f], leds);
+            cycles[f] = readCycleCounter() - c0;
+        }
+        std::nth_element(cycles.begin(), cycles.begin() + cycles.size() / 2, cycles.end());
+        best = std::min(best, cycles[cycles.size() / 2]);
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    int frames = (argc > 1) ? atoi(argv[1]) : 2000;
+    if (frames < 1) frames = 1;
+    if (!loadSessionProgram(ACTIVE_SESSION_PROGRAM)) {
+        fprintf(stderr, "session program: %s\n", activeProgram().error);
+        return 1;
+    }
+
+    OscillatorBank bank;
+    bank.init();
+    uint64_t startUs = (uint64_t)(RAMP_IN_SECONDS * 1e6f);
+    std::vector<FrameParams> base(frames);
+    for (int f = 0; f < frames; ++f) base[f] = computeFrameParams(bank, startUs + (uint64_t)f * FRAME_PERIOD_US);
+
+    static CRGB a[NUM_LEDS], b[NUM_LEDS];
+    double mhz = (double)cycleCounterHz() * 1e-6;
+    bool identical = true;
+
+    printf("%s, NUM_LEDS %d, %d frames per mode, %.0f MHz counter%s\n", topology().name, NUM_LEDS, frames,
+           mhz, USE_HOT_PATH_PROFILER ? " (profiler stamps enabled)" : "");
+    printf("%-13s", "mode");
+    for (const Backend &be : BACKENDS) printf(" %12s", be.name);
+    printf(" %9s\n", "speedup");
+
+    for (int mode = 0; mode < 3; ++mode) {
+        std::vector<FrameParams> params = base;
+        for (FrameParams &fp : params) fp.mandalaMode = mode;
+
+        for (const FrameParams &fp : params) {
+            renderFrameLegacy(fp, a);
+            renderFrameFloat(fp, b);
+            if (LED_LAYOUT == 0 && memcmp(a, b, sizeof(a)) != 0) identical = false;
+        }
+
+        uint32_t cycles[BACKEND_COUNT];
+        printf("%-13s", MODE_NAMES[mode]);
+        for (int k = 0; k < BACKEND_COUNT; ++k) {
+            cycles[k] = timeBackend(BACKENDS[k].render, params, a);
+            printf(" %12u", (unsigned)cycles[k]);
+        }
+        printf(" %8.2fx\n", (double)cycles[0] / (double)cycles[1]);
+    }
+    printf("cycles per frame (median); speedup = legacy / float\n");
+
+    if (!identical) {
+        printf("FAIL: float path differs from the legacy reference\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+    ================================================================
+                    OFFLINE SESSION RENDERER (host)
+    ================================================================
+
+    Renders a whole session, ramp-in through fade-out, as fast as the CPU
+    allows and writes it as a session file (see session_file.h).
+
+    Frame k is rendered for the moment it becomes visible,
+    k * FRAME_PERIOD_US + WIRE_PRESENTATION_US, exactly as loop() does
+    with no scheduling jitter. Frames depend only on that time, so the
+    timeline is split into one contiguous slice per thread; each worker
+    seeks its own oscillator bank to the start of its slice. The output
+    pass (curve and master level) runs afterwards in frame order, since temporal
+    dithering (dither.h) and the power limiter (power.h) carry state from
+    frame to frame. The output is
+    byte-identical for any thread count.
+
+    Usage: render_session [-o file] [-j threads] [-s seconds] [-p program]
+      -o  output path (default session.bin)
+      -j  worker threads (default: all cores)
+      -s  stop after this much session time (default: whole session)
+      -p  session program index (default SESSION_PROGRAM)
+*/
+
+#include <FastLED.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "dither.h"
+#include "gamma.h"
+#include "power.h"
+#include "presentation.h"
+#include "render.h"
+#include "session_file.h"
+
+constexpr uint32_t RECORD_BYTES = sizeof(uint32_t) + NUM_LEDS * 3;
+
+static uint64_t frameVisibleUs(uint64_t frame) {
+    uint64_t us = frame * FRAME_PERIOD_US;
+    if (USE_PRESENTATION_COMPENSATION) us += WIRE_PRESENTATION_US;
+    return us;
+}
+
+/*
+    Number of frames before the fade-out reaches black (where loop()
+    blanks the strip and halts), capped at `maxSeconds`.
+*/
+static uint64_t sessionFrameCount(double maxSeconds) {
+    uint64_t limitUs = (uint64_t)(maxSeconds * 1000000.0);
+    uint64_t n = 0;
+    while (frameVisibleUs(n) < limitUs && !sessionFinished((float)frameVisibleUs(n) * 0.000001f)) n++;
+    return n;
+}
+
+// Records hold the rendered frame until applyOutput()
+static void renderSlice(uint64_t first, uint64_t last, uint8_t *out, uint32_t *master) {
+    OscillatorBank bank;
+    bank.init();
+    bank.seek(frameVisibleUs(first));
+
+    CRGB frame[NUM_LEDS];
+    for (uint64_t k = first; k < last; ++k) {
+        uint64_t us = frameVisibleUs(k);
+        FrameParams fp = computeFrameParams(bank, us);
+        renderFrame(fp, frame);
+        master[k - first] = outputMaster(fp.master);
+
+        uint8_t *rec = out + (k - first) * RECORD_BYTES;
+        uint32_t stamp = (uint32_t)us;
+        memcpy(rec, &stamp, sizeof(stamp));
+        memcpy(rec + sizeof(stamp), frame, sizeof(frame));
+    }
+}
+
+// What ledOutputShow() sends, frame by frame
+static void applyOutput(uint8_t *records, const uint32_t *master, uint64_t frames) {
+    static TemporalDither dither;
+    static PowerLimiter limiter;
+    limiter.reset(POWER_LIMIT_MA, activeProgram().holdSeconds);   // as setup() does
+    for (uint64_t k = 0; k < frames; ++k) {
+        CRGB *frame = (CRGB *)(records + k * RECORD_BYTES + sizeof(uint32_t));
+        uint32_t level = limiter.limit(master[k]);
+        limiter.update(USE_TEMPORAL_DITHER ? dither.apply(outputCurve(), frame, level)
+                                           : applyOutputCurve(outputCurve(), frame, level));
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: render_session [-o file] [-j threads] [-s seconds] [-p program]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *outPath = "session.bin";
+    unsigned threads = std::thread::hardware_concurrency();
+    double maxSeconds = MAX_SESSION_SECONDS + FADE_OUT_SECONDS;
+    int program = ACTIVE_SESSION_PROGRAM;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        if      (strcmp(argv[i], "-o") == 0) outPath = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0) threads = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0) maxSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0) program = atoi(argv[++i]);
+        else usage();
+    }
+    if (threads == 0) threads = 1;
+    if (!loadSessionProgram(program)) {
+        fprintf(stderr, "session program %d: %s (segment %d)\n", program,
+                activeProgram().error, activeProgram().errorSegment);
+        return 1;
+    }
+
+    uint64_t frames = sessionFrameCount(maxSeconds);
+
+    SessionFileHeader header = {};
+    memcpy(header.magic, SESSION_FILE_MAGIC, sizeof(header.magic));
+    header.version       = SESSION_FILE_VERSION;
+    header.headerBytes   = sizeof(SessionFileHeader);
+    header.numLeds       = NUM_LEDS;
+    header.recordBytes   = RECORD_BYTES;
+    header.framePeriodUs = FRAME_PERIOD_US;
+    header.flags         = (RENDER_FIXED_POINT ? SESSION_FLAG_FIXED_POINT : 0) |
+                           (USE_PRESENTATION_COMPENSATION ? SESSION_FLAG_PRESENTATION : 0) |
+                           (USE_TEMPORAL_DITHER ? SESSION_FLAG_DITHERED : 0);
+    header.frameCount    = frames;
+    header.leftHz        = activeProgram().source->segments[0].leftHz;
+    header.rightHz       = activeProgram().source->segments[0].rightHz;
+
+    std::vector<uint8_t> records(frames * RECORD_BYTES);
+    std::vector<uint32_t> master(frames);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    uint64_t perThread = (frames + threads - 1) / threads;
+    for (unsigned w = 0; w < threads; ++w) {
+        uint64_t first = w * perThread;
+        uint64_t last  = (first + perThread < frames) ? first + perThread : frames;
+        if (first >= last) break;
+        workers.emplace_back(renderSlice, first, last, records.data() + first * RECORD_BYTES,
+                             master.data() + first);
+    }
+    for (std::thread &t : workers) t.join();
+    applyOutput(records.data(), master.data(), frames);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    FILE *f = fopen(outPath, "wb");
+    if (f == nullptr) {
+        perror(outPath);
+        return 1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(records.data(), 1, records.size(), f) == records.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        perror(outPath);
+        return 1;
+    }
+
+    // FNV-1a over the records, to compare runs
+    uint32_t hash = 2166136261u;
+    for (uint8_t b : records) hash = (hash ^ b) * 16777619u;
+
+    printf("%s: %llu frames (%.1f s of session), %zu threads, %.3f s, %.0f frames/s, fnv %08x\n",
+           outPath, (unsigned long long)frames, (double)frames * FRAME_PERIOD_US / 1e6,
+           workers.size(), seconds, seconds > 0 ? (double)frames / seconds : 0.0, (unsigned)hash);
+    return 0;
+}
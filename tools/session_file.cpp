@@ -0,0 +1,53 @@
+#include "session_file.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool SessionFile::open(const char *path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SessionFileHeader)) {
+        fprintf(stderr, "%s: too short for a session header\n", path);
+        ::close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    header = (const SessionFileHeader *)map;
+    mappedBytes = (size_t)st.st_size;
+
+    const SessionFileHeader &h = *header;
+    bool ok = memcmp(h.magic, SESSION_FILE_MAGIC, sizeof(h.magic)) == 0 &&
+              h.version == SESSION_FILE_VERSION &&
+              h.recordBytes == sizeof(uint32_t) + h.numLeds * 3 &&
+              h.headerBytes >= sizeof(SessionFileHeader) &&
+              h.headerBytes + h.frameCount * h.recordBytes <= mappedBytes;
+    if (!ok) {
+        fprintf(stderr, "%s: not a version %u session file\n", path, (unsigned)SESSION_FILE_VERSION);
+        close();
+        return false;
+    }
+    records = (const uint8_t *)map + h.headerBytes;
+    return true;
+}
+
+void SessionFile::close() {
+    if (header != nullptr) munmap((void *)header, mappedBytes);
+    header = nullptr;
+    records = nullptr;
+    mappedBytes = 0;
+}
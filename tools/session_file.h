@@ -0,0 +1,72 @@
+/*
+    ================================================================
+                   RENDERED SESSION FILE FORMAT (host)
+    ================================================================
+
+    Output of render_session, input of the analysis tools. Little-endian,
+    fixed-size records so a reader can mmap() the file and index frames
+    directly:
+
+        SessionFileHeader                      64 bytes
+        record[frameCount]                     recordBytes each
+            uint32_t presentUs                 visible time since session start
+            uint8_t  rgb[numLeds * 3]          as sent: physical LED order,
+                                               master level already applied
+
+    With the default 20 LEDs a record is 64 bytes.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+constexpr char     SESSION_FILE_MAGIC[8] = {'T', 'H', 'E', 'T', 'A', 'S', 'E', 'S'};
+constexpr uint32_t SESSION_FILE_VERSION = 1;
+
+// SessionFileHeader::flags
+constexpr uint32_t SESSION_FLAG_FIXED_POINT  = 1u << 0;   // rendered with the Q15 path
+constexpr uint32_t SESSION_FLAG_PRESENTATION = 1u << 1;   // presentation-compensated
+constexpr uint32_t SESSION_FLAG_DITHERED     = 1u << 2;   // temporally dithered output
+
+struct SessionFileHeader {
+    char     magic[8];        // SESSION_FILE_MAGIC
+    uint32_t version;         // SESSION_FILE_VERSION
+    uint32_t headerBytes;     // offset of the first record
+    uint32_t numLeds;
+    uint32_t recordBytes;     // 4 + numLeds * 3
+    uint32_t framePeriodUs;
+    uint32_t flags;           // SESSION_FLAG_*
+    uint64_t frameCount;
+    float    leftHz;
+    float    rightHz;
+    uint32_t reserved[4];
+};
+
+static_assert(sizeof(SessionFileHeader) == 64, "session header layout");
+
+/*
+    Read-only mmap() view of a session file.
+*/
+struct SessionFile {
+    const SessionFileHeader *header = nullptr;
+    const uint8_t           *records = nullptr;
+    size_t                   mappedBytes = 0;
+
+    // false (and prints why) if the file is missing or malformed
+    bool open(const char *path);
+    void close();
+
+    uint64_t frameCount() const { return header->frameCount; }
+
+    uint32_t presentUs(uint64_t frame) const {
+        uint32_t us;
+        memcpy(&us, records + frame * header->recordBytes, sizeof(us));
+        return us;
+    }
+
+    const uint8_t *rgb(uint64_t frame) const {
+        return records + frame * header->recordBytes + sizeof(uint32_t);
+    }
+};
@@ -0,0 +1,314 @@
+/*
+    ================================================================
+                 SPECTRAL VERIFICATION OF A RENDERED SESSION
+    ================================================================
+
+    Reads a session file (render_session) and checks what the eyes
+    actually receive: per-LED and per-eye luminance, Welch-averaged
+    spectra, and for each channel
+
+        fund      RMS of the eye frequency (LEFT_FREQ_HZ / RIGHT_FREQ_HZ)
+        H2..H5    harmonic levels, dB relative to the fundamental
+        THD       sqrt(sum of all harmonic power below Nyquist) / fund
+        xtalk     the other eye's frequency, dBc
+        breath    strongest BREATH_FREQ_HZ sideband of the fundamental, dBc
+        micro     MICRO_FREQ_HZ shimmer line, dBc
+
+    Luminance is linear light, weighted with Rec.709 coefficients: each
+    byte as sent goes through the LED response, duty^LED_RESPONSE_GAMMA
+    (config.h, linear for an ideal WS2812B). An LED's eye comes from the
+    topology table (topology.h), the same one renderFrame() uses for the
+    stereo mix, so the file must come from a build with the same
+    LED_LAYOUT and LED response.
+
+    Spectra use a 4-term Blackman-Harris window (-92 dB sidelobes), so
+    harmonics 60+ dB down stay visible. Tone levels integrate the window
+    main lobe (±4 bins). Channels are transformed two at a time as the real
+    and imaginary parts of one complex FFT, sharing one twiddle table.
+
+    Usage: spectrum session.bin [-a start] [-b end] [-n fft] [-g max-thd-%]
+      -a/-b  analysis window in session seconds
+             (default RAMP_IN_SECONDS .. MAX_SESSION_SECONDS)
+      -n     FFT length, power of two (default 16384)
+      -g     regression gate: exit 1 if either eye's THD exceeds this
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <complex>
+#include <vector>
+
+#include "config.h"
+#include "fft.h"
+#include "session_file.h"
+#include "topology.h"
+
+constexpr int    MAX_HARMONIC    = 8;
+constexpr int    TONE_HALF_BINS  = 4;   // Blackman-Harris main lobe half-width
+constexpr double LUMA_R = 0.2126, LUMA_G = 0.7152, LUMA_B = 0.0722;
+
+/* ---------------- CHANNELS ---------------- */
+
+struct Channel {
+    char                name[16];
+    int                 eye;        // 0 left, 1 right
+    std::vector<float>  luma;       // one sample per frame
+    std::vector<double> power;      // accumulated one-sided |X|^2
+    double              mean = 0.0;
+};
+
+// Light of a drive byte per channel, 0..255
+static float channelLight[3][256];
+
+static void initChannelLight() {
+    for (int c = 0; c < 3; ++c) {
+        for (int d = 0; d < 256; ++d) {
+            channelLight[c][d] = (float)(255.0 * pow(d / 255.0, (double)LED_RESPONSE_GAMMA[c]));
+        }
+    }
+}
+
+static bool isLeftEyeLed(int physical) {
+    const Topology &t = topology();
+    return t.eye[t.rankOf[physical]] == 0;
+}
+
+/* ---------------- WELCH PSD ---------------- */
+
+/*
+    Welch average: 50 % overlapped Blackman-Harris segments,
+    mean removed per segment, two channels per complex FFT.
+*/
+static int welch(std::vector<Channel> &chans, size_t first, size_t count, const FftPlan &plan,
+                 std::vector<double> &window) {
+    size_t n = plan.n;
+    window.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * (double)i / (double)(n - 1);
+        window[i] = 0.35875 - 0.48829 * cos(a) + 0.14128 * cos(2 * a) - 0.01168 * cos(3 * a);
+    }
+    for (Channel &c : chans) c.power.assign(n / 2 + 1, 0.0);
+
+    std::vector<cplx> buf(n);
+    int segments = 0;
+    for (size_t start = first; start + n <= first + count; start += n / 2, ++segments) {
+        for (size_t c = 0; c < chans.size(); c += 2) {
+            const float *xa = chans[c].luma.data() + start;
+            const float *xb = (c + 1 < chans.size()) ? chans[c + 1].luma.data() + start : nullptr;
+
+            double ma = 0.0, mb = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                ma += xa[i];
+                if (xb) mb += xb[i];
+            }
+            ma /= (double)n;
+            mb /= (double)n;
+            for (size_t i = 0; i < n; ++i) {
+                buf[i] = cplx((xa[i] - ma) * window[i], xb ? (xb[i] - mb) * window[i] : 0.0);
+            }
+            plan.forward(buf.data());
+
+            // Split Z = X + iY back into the two real spectra
+            for (size_t k = 0; k <= n / 2; ++k) {
+                cplx zk = buf[k], zn = std::conj(buf[(n - k) & (n - 1)]);
+                cplx xk = 0.5 * (zk + zn);
+                chans[c].power[k] += std::norm(xk);
+                if (xb) {
+                    cplx yk = cplx(0.0, -0.5) * (zk - zn);
+                    chans[c + 1].power[k] += std::norm(yk);
+                }
+            }
+        }
+    }
+    return segments;
+}
+
+/* ---------------- TONE MEASUREMENT ---------------- */
+
+struct SpectrumScale {
+    double binHz;
+    double norm;   // |X|^2 sum -> mean-square of the tone
+    size_t bins;
+};
+
+/*
+    Mean-square of the tone at `hz`: one-sided power summed over the
+    window main lobe. 0 above Nyquist.
+*/
+static double tonePower(const Channel &c, const SpectrumScale &s, double hz) {
+    long k0 = lround(hz / s.binHz);
+    if (k0 < 0 || (size_t)k0 >= s.bins) return 0.0;
+    double p = 0.0;
+    for (long k = k0 - TONE_HALF_BINS; k <= k0 + TONE_HALF_BINS; ++k) {
+        if (k > 0 && (size_t)k < s.bins) p += c.power[k];
+    }
+    return 2.0 * p * s.norm;
+}
+
+static double dbc(double p, double ref) {
+    if (ref <= 0.0) return 0.0;
+    return p > 0.0 ? 10.0 * log10(p / ref) : -999.0;
+}
+
+struct ToneReport {
+    double fundHz;
+    double fundRms;
+    double harmonicDbc[MAX_HARMONIC + 1];   // [2..MAX_HARMONIC]
+    int    harmonics;                        // harmonics below Nyquist
+    double thd;                              // ratio, not %
+    double xtalkDbc;
+    double breathDbc;
+    double microDbc;
+};
+
+static ToneReport measure(const Channel &c, const SpectrumScale &s, double fundHz, double otherHz) {
+    double nyquist = s.binHz * (double)(s.bins - 1);
+    ToneReport r = {};
+    r.fundHz = fundHz;
+    double fund = tonePower(c, s, fundHz);
+    r.fundRms = sqrt(fund);
+
+    double harmonicSum = 0.0;
+    for (int h = 2; h <= MAX_HARMONIC && h * fundHz < nyquist - TONE_HALF_BINS * s.binHz; ++h) {
+        double p = tonePower(c, s, h * fundHz);
+        harmonicSum += p;
+        r.harmonicDbc[h] = dbc(p, fund);
+        r.harmonics = h - 1;
+    }
+    r.thd = fund > 0.0 ? sqrt(harmonicSum / fund) : 0.0;
+    r.xtalkDbc = dbc(tonePower(c, s, otherHz), fund);
+
+    double lower = tonePower(c, s, fundHz - BREATH_FREQ_HZ);
+    double upper = tonePower(c, s, fundHz + BREATH_FREQ_HZ);
+    r.breathDbc = dbc(lower > upper ? lower : upper, fund);
+    r.microDbc = dbc(tonePower(c, s, MICRO_FREQ_HZ), fund);
+    return r;
+}
+
+static void printRow(const Channel &c, const ToneReport &r) {
+    printf("%-8s %6.1f %5.2f %7.3f", c.name, c.mean, r.fundHz, r.fundRms);
+    for (int h = 2; h <= 5; ++h) {
+        if (h - 1 <= r.harmonics) printf(" %6.1f", r.harmonicDbc[h]);
+        else                      printf("      -");
+    }
+    printf(" %6.2f%% %6.1f %6.1f %6.1f\n", 100.0 * r.thd, r.xtalkDbc, r.breathDbc, r.microDbc);
+}
+
+/* ---------------- MAIN ---------------- */
+
+static void usage() {
+    fprintf(stderr, "usage: spectrum session.bin [-a start] [-b end] [-n fft] [-g max-thd-%%]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) usage();
+    const char *path = argv[1];
+    double startS = RAMP_IN_SECONDS, endS = MAX_SESSION_SECONDS;
+    size_t fftSize = 16384;
+    double gateThd = -1.0;
+
+    for (int i = 2; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        if      (strcmp(argv[i], "-a") == 0) startS = atof(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0) endS = atof(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0) fftSize = (size_t)atol(argv[++i]);
+        else if (strcmp(argv[i], "-g") == 0) gateThd = atof(argv[++i]) / 100.0;
+        else usage();
+    }
+    if (fftSize < 64 || (fftSize & (fftSize - 1)) != 0) usage();
+
+    SessionFile session;
+    if (!session.open(path)) return 1;
+    const SessionFileHeader &h = *session.header;
+    if (h.numLeds != NUM_LEDS) {
+        fprintf(stderr, "%s: %u LEDs, this build expects %d\n", path, (unsigned)h.numLeds, NUM_LEDS);
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    // Frame range inside [startS, endS)
+    uint64_t first = 0, last = session.frameCount();
+    while (first < last && session.presentUs(first) < (uint64_t)(startS * 1e6)) first++;
+    uint64_t end = first;
+    while (end < last && session.presentUs(end) < (uint64_t)(endS * 1e6)) end++;
+    size_t count = (size_t)(end - first);
+    if (count < fftSize) {
+        fprintf(stderr, "only %zu frames in %.1f..%.1f s, need at least %zu\n", count, startS, endS, fftSize);
+        return 1;
+    }
+
+    // Luminance series: one channel per LED, then one per eye
+    std::vector<Channel> chans(NUM_LEDS + 2);
+    for (int i = 0; i < NUM_LEDS; ++i) {
+        snprintf(chans[i].name, sizeof(chans[i].name), "led%d", i);
+        chans[i].eye = isLeftEyeLed(i) ? 0 : 1;
+    }
+    snprintf(chans[NUM_LEDS].name, sizeof(chans[NUM_LEDS].name), "left");
+    snprintf(chans[NUM_LEDS + 1].name, sizeof(chans[NUM_LEDS + 1].name), "right");
+    chans[NUM_LEDS].eye = 0;
+    chans[NUM_LEDS + 1].eye = 1;
+    for (Channel &c : chans) c.luma.resize(count);
+
+    initChannelLight();
+    int eyeLeds[2] = {0, 0};
+    for (int i = 0; i < NUM_LEDS; ++i) eyeLeds[chans[i].eye]++;
+
+    for (size_t f = 0; f < count; ++f) {
+        const uint8_t *rgb = session.rgb(first + f);
+        float eyeSum[2] = {0.0f, 0.0f};
+        for (int i = 0; i < NUM_LEDS; ++i) {
+            float y = (float)(LUMA_R * channelLight[0][rgb[3 * i]] + LUMA_G * channelLight[1][rgb[3 * i + 1]] +
+                              LUMA_B * channelLight[2][rgb[3 * i + 2]]);
+            chans[i].luma[f] = y;
+            eyeSum[chans[i].eye] += y;
+        }
+        chans[NUM_LEDS].luma[f]     = eyeSum[0] / (float)eyeLeds[0];
+        chans[NUM_LEDS + 1].luma[f] = eyeSum[1] / (float)eyeLeds[1];
+    }
+    for (Channel &c : chans) {
+        double sum = 0.0;
+        for (float y : c.luma) sum += y;
+        c.mean = sum / (double)count;
+    }
+
+    FftPlan plan;
+    plan.init(fftSize);
+    std::vector<double> window;
+    int segments = welch(chans, 0, count, plan, window);
+
+    double w2 = 0.0;
+    for (double w : window) w2 += w * w;
+    SpectrumScale scale;
+    scale.binHz = 1e6 / (double)h.framePeriodUs / (double)fftSize;
+    scale.norm  = 1.0 / ((double)fftSize * w2 * (double)segments);
+    scale.bins  = fftSize / 2 + 1;
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("%s: %.1f..%.1f s, %zu frames, %d x %zu-point segments, %.4f Hz/bin, %.1f ms\n",
+           path, startS, endS, count, segments, fftSize, scale.binHz, elapsed * 1e3);
+    printf("levels: luminance 0..255 (Rec.709), RMS; harmonics, xtalk, breath, micro in dBc\n\n");
+    printf("%-8s %6s %5s %7s %6s %6s %6s %6s %7s %6s %6s %6s\n",
+           "channel", "mean", "f", "fund", "H2", "H3", "H4", "H5", "THD", "xtalk", "breath", "micro");
+
+    const double eyeHz[2] = {h.leftHz, h.rightHz};
+    bool gateFailed = false;
+    for (size_t c = 0; c < chans.size(); ++c) {
+        if (c == NUM_LEDS) printf("\n");
+        int eye = chans[c].eye;
+        ToneReport r = measure(chans[c], scale, eyeHz[eye], eyeHz[1 - eye]);
+        printRow(chans[c], r);
+        if (c >= NUM_LEDS && gateThd >= 0.0 && r.thd > gateThd) gateFailed = true;
+    }
+
+    if (gateThd >= 0.0) {
+        printf("\nTHD gate %.2f%%: %s\n", 100.0 * gateThd, gateFailed ? "FAIL" : "pass");
+    }
+    return gateFailed ? 1 : 0;
+}
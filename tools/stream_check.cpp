@@ -0,0 +1,397 @@
+/*
+    ================================================================
+                FRAME STREAM LOOPBACK CHECK (host, pty)
+    ================================================================
+
+    Runs the unmodified sketch, built with FRAME_STREAM=1, on the real
+    host clock with its Serial on a pseudo-terminal, and streams frames
+    into the other end with the stream_send code (stream_sender.h), as
+    a PC would over the UART. The frames the FastLED shim captured are
+    then matched against what was sent.
+
+    Each scenario runs in a child process of its own (the sketch has one
+    session per boot):
+
+      stream   STREAM_FRAMES distinct frames. Sending stalls for
+               STALL_US before frame STALL_AT, one packet (CORRUPT_AT)
+               has a flipped byte, an 's' key asks for the stats, and a
+               STREAM_END closes the stream. Passes if every frame outside
+               the stall was shown on its own deadline, through the
+               output curve and master level; the corrupt one was
+               rejected and its predecessor held; the stall was counted
+               as underruns, and the frames it made miss their deadline
+               were skipped; the 's' stats came back; and the strip went
+               dark on the end marker's deadline.
+      panic    the panic button is pressed PANIC_AT_US after the first
+               frame is shown.
+               Passes if nothing but black is shown after the press and
+               the output was confirmed dark.
+
+    Frames are compared exactly, so the env builds with TEMPORAL_DITHER=0.
+    A busy machine can wake the loop past a deadline, so up to
+    ON_TIME_SLACK_PERCENT of the frames may miss theirs.
+
+    Usage: stream_check
+*/
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "config.h"
+#include "frame_pipeline.h"
+#include "frame_stream.h"
+#include "gamma.h"
+#include "led_output.h"
+#include "panic.h"
+#include "render.h"
+#include "stream_sender.h"
+
+static_assert(USE_FRAME_STREAM, "stream_check builds with -DFRAME_STREAM=1");
+static_assert(!USE_TEMPORAL_DITHER, "stream_check compares exact bytes: -DTEMPORAL_DITHER=0");
+
+constexpr int      STREAM_FRAMES    = 300;
+constexpr uint32_t FIRST_PRESENT_US = 1000000;   // any origin: the device anchors it
+constexpr int      STALL_AT         = 120;
+constexpr uint32_t STALL_US         = 200000;
+constexpr int      STALL_RECOVERY   = 30;         // frames after STALL_AT not timed
+constexpr int      CORRUPT_AT       = 220;
+constexpr int      KEY_AFTER        = 250;
+constexpr uint32_t PANIC_AT_US      = 1500000;    // after the first frame is shown
+constexpr double   RUN_SECONDS      = 5.5;        // boot, stream, then halted
+
+// Timing is read off show() times on the real clock: a loop() woken more
+// than half a period late lands a frame on the next deadline. A real
+// timing fault moves them all.
+constexpr int ON_TIME_SLACK_PERCENT = 1;
+
+static uint32_t presentOf(int k) {
+    return FIRST_PRESENT_US + (uint32_t)k * FRAME_PERIOD_US;
+}
+
+// Distinct, reproducible content for frame k
+static std::vector<uint8_t> sentFrame(int k) {
+    std::vector<uint8_t> rgb(NUM_LEDS * 3);
+    uint32_t x = 0x9E3779B9u * (uint32_t)(k + 1);
+    for (uint8_t &b : rgb) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        b = (uint8_t)(x >> 24);
+    }
+    return rgb;
+}
+
+/* ---------------- PTY ---------------- */
+
+struct Loopback {
+    int               master = -1;   // the "PC" end
+    int               slave  = -1;   // the sketch's Serial
+    std::thread       reader;
+    std::mutex        lock;
+    std::string       output;        // everything the sketch printed
+    std::atomic<bool> ready{false};  // setup() finished
+    std::atomic<bool> stopping{false};
+
+    bool open() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            perror("posix_openpt");
+            return false;
+        }
+        slave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+        if (slave < 0) {
+            perror(ptsname(master));
+            return false;
+        }
+        // Raw, no echo: the slave side stands in for a UART
+        struct termios tio;
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+        reader = std::thread([this] { readOutput(); });
+        return true;
+    }
+
+    void readOutput() {
+        char buf[4096];
+        while (!stopping) {
+            struct pollfd p = {master, POLLIN, 0};
+            if (poll(&p, 1, 20) <= 0) continue;
+            ssize_t n = read(master, buf, sizeof(buf));
+            if (n <= 0) {
+                if (n < 0 && errno == EAGAIN) continue;
+                return;
+            }
+            std::lock_guard<std::mutex> g(lock);
+            output.append(buf, (size_t)n);
+            if (output.find("System ready") != std::string::npos) ready = true;
+        }
+    }
+
+    // Host → sketch; false once the run is over
+    bool send(const std::vector<uint8_t> &data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            if (stopping) return false;
+            ssize_t n = write(master, data.data() + done, data.size() - done);
+            if (n > 0) {
+                done += (size_t)n;
+            } else {
+                struct pollfd p = {master, POLLOUT, 0};
+                poll(&p, 1, 20);   // the sketch isn't reading (halted, or behind)
+            }
+        }
+        return true;
+    }
+
+    std::string text() {
+        std::lock_guard<std::mutex> g(lock);
+        return output;
+    }
+
+    void close() {
+        stopping = true;
+        if (reader.joinable()) reader.join();
+        ::close(slave);
+        ::close(master);
+    }
+};
+
+/*
+    Boot the sketch on `lb` and run it for RUN_SECONDS of real time while
+    `sender` runs on its own thread. With `panicAfterUs` > 0 the panic
+    button is pressed between two loop() calls that long after the first
+    streamed frame was shown; returns when (getTimeMicros()), else 0.
+*/
+template <typename Sender>
+static uint64_t runSketch(Loopback &lb, Sender sender, uint64_t panicAfterUs) {
+    hostSerialAttach(lb.slave);
+    FastLED.hostSetFrameCapture((size_t)(RUN_SECONDS * 1e6 / FRAME_PERIOD_US) + 100);
+    uint64_t stopAt = readCounterMicros() + (uint64_t)(RUN_SECONDS * 1e6);
+    hostSetStopAt(stopAt);
+
+    std::thread send(sender);
+    uint64_t pressAtUs = 0, pressedUs = 0;
+    try {
+        setup();
+        while (readCounterMicros() < stopAt) {
+            loop();
+            if (panicAfterUs == 0 || pressedUs != 0) continue;
+            if (pressAtUs == 0 && streamStats().shown > 0) pressAtUs = getTimeMicros() + panicAfterUs;
+            if (pressAtUs != 0 && getTimeMicros() >= pressAtUs) {
+                pressedUs = getTimeMicros();
+                hostSetPinLevel(PANIC_PIN, LOW);
+            }
+        }
+    } catch (const HostStop &) {
+        // halted inside a delay() loop (panic or end of stream)
+    }
+    stopOutputPipeline();
+    lb.stopping = true;
+    send.join();
+    hostSerialAttach(-1);
+    return pressedUs;
+}
+
+static void waitReady(Loopback &lb) {
+    while (!lb.ready && !lb.stopping) usleep(1000);
+}
+
+/* ---------------- MATCHING ---------------- */
+
+struct Shown {
+    uint64_t us;
+    int      frame;   // sent frame index; -1 black, -2 unknown
+};
+
+// Each captured frame, identified by the output bytes each sent frame should produce
+static std::vector<Shown> identify(int frames) {
+    uint32_t master = outputMaster(sessionLevel(0.0f));
+    std::map<std::vector<uint8_t>, int> expected;
+    for (int k = 0; k < frames; ++k) {
+        std::vector<uint8_t> rgb = sentFrame(k);
+        applyOutputCurve(outputCurve(), (CRGB *)rgb.data(), master);
+        expected[rgb] = k;
+    }
+
+    std::vector<Shown> out;
+    for (const HostShownFrame &f : FastLED.hostFrames()) {
+        std::vector<uint8_t> bytes((const uint8_t *)f.pixels.data(), (const uint8_t *)(f.pixels.data() + f.pixels.size()));
+        bool black = true;
+        for (uint8_t b : bytes) black = black && b == 0;
+        auto it = expected.find(bytes);
+        out.push_back({f.us, black ? -1 : (it == expected.end() ? -2 : it->second)});
+    }
+    return out;
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what) {
+    printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+/* ---------------- SCENARIOS ---------------- */
+
+static int checkStream() {
+    Loopback lb;
+    if (!lb.open()) return 1;
+    runSketch(lb, [&] {
+        waitReady(lb);
+        StreamPacer pacer;
+        std::vector<uint8_t> packet;
+        for (int k = 0; k < STREAM_FRAMES; ++k) {
+            if (k == STALL_AT) usleep(STALL_US);
+            packet.clear();
+            streamEncodeFrame(packet, presentOf(k), sentFrame(k).data());
+            if (k == CORRUPT_AT) packet[STREAM_HEADER_BYTES + 10] ^= 0x40;
+            if (k == KEY_AFTER) streamEncodeKey(packet, 's');
+            pacer.waitToSend(presentOf(k));
+            if (!lb.send(packet)) return;
+        }
+        packet.clear();
+        streamEncodeEnd(packet, presentOf(STREAM_FRAMES));
+        pacer.waitToSend(presentOf(STREAM_FRAMES));
+        lb.send(packet);
+    }, 0);
+
+    std::string text = lb.text();
+    lb.close();
+    std::vector<Shown> shown = identify(STREAM_FRAMES);
+    const StreamStats &st = streamStats();
+
+    // First deadline each frame was shown on, counted from frame 0's
+    std::vector<int> firstAt(STREAM_FRAMES, -1), shownFor(STREAM_FRAMES, 0);
+    size_t first = 0, last = 0;
+    while (first < shown.size() && shown[first].frame == -1) first++;
+    bool known = true, ordered = true, gap = false;
+    int prev = -1;
+    for (size_t i = first; i < shown.size(); ++i) {
+        const Shown &s = shown[i];
+        if (s.frame == -2) known = false;
+        if (s.frame < 0) continue;
+        if (s.frame < prev) ordered = false;
+        if (prev >= 0 && last + 1 != i) gap = true;   // black in between
+        prev = s.frame;
+        last = i;
+        shownFor[s.frame]++;
+        if (firstAt[s.frame] < 0 && first < shown.size()) {
+            int64_t d = (int64_t)(s.us - shown[first].us);
+            firstAt[s.frame] = (int)((d + FRAME_PERIOD_US / 2) / FRAME_PERIOD_US);
+        }
+    }
+    bool started = first < shown.size() && shown[first].frame == 0;
+    int onTime = 0, timed = 0;
+    for (int k = 0; k < STREAM_FRAMES; ++k) {
+        if ((k >= STALL_AT && k < STALL_AT + STALL_RECOVERY) || k == CORRUPT_AT) continue;
+        timed++;
+        if (firstAt[k] == k) onTime++;
+    }
+    bool darkOnEnd = started && last + 1 < shown.size() && shown[last + 1].frame == -1 &&
+                     (int)((shown[last + 1].us - shown[first].us + FRAME_PERIOD_US / 2) / FRAME_PERIOD_US) ==
+                         STREAM_FRAMES;
+    int stallDeadlines = (int)((STALL_US - STREAM_PREROLL_US) / FRAME_PERIOD_US);
+
+    printf("stream: %d frames, stall of %u ms at frame %d, frame %d corrupted\n", STREAM_FRAMES,
+           (unsigned)(STALL_US / 1000), STALL_AT, CORRUPT_AT);
+    printf("  received %u, rejected %u, shown %u, late %u, skipped %u, held %u, underruns %u, max queued %u\n",
+           (unsigned)st.received, (unsigned)st.rejected, (unsigned)st.shown, (unsigned)st.late,
+           (unsigned)st.skipped, (unsigned)st.held, (unsigned)st.underruns, (unsigned)st.maxQueued);
+    printf("  %d of %d frames outside the stall on their own deadline\n", onTime, timed);
+    expect(started, "black until the first frame, then frame 0");
+    expect(known && ordered && !gap, "every frame sent as output curve + master, in order");
+    expect(onTime >= timed - timed * ON_TIME_SLACK_PERCENT / 100, "frames outside the stall on their deadline");
+    expect(st.received == STREAM_FRAMES && st.rejected == 1, "corrupt packet rejected, the rest received");
+    expect(shownFor[CORRUPT_AT] == 0 && shownFor[CORRUPT_AT - 1] == 2, "corrupt frame never shown, previous held");
+    expect((int)st.underruns >= stallDeadlines - 2, "stall counted as underruns");
+    expect((int)st.skipped >= stallDeadlines - 2, "frames missed in the stall skipped, not shown late");
+    expect(darkOnEnd, "dark on the end marker's deadline");
+    expect(text.find("Stream: received") != std::string::npos, "'s' key packet printed the stats");
+    expect(text.find("Frame stream ended") != std::string::npos, "session ended by the stream");
+    return failures == 0 ? 0 : 1;
+}
+
+static int checkPanic() {
+    Loopback lb;
+    if (!lb.open()) return 1;
+    uint64_t press = runSketch(lb, [&] {
+        waitReady(lb);
+        StreamPacer pacer;
+        std::vector<uint8_t> packet;
+        for (int k = 0; k < STREAM_FRAMES; ++k) {
+            packet.clear();
+            streamEncodeFrame(packet, presentOf(k), sentFrame(k).data());
+            pacer.waitToSend(presentOf(k));
+            if (!lb.send(packet)) return;
+        }
+    }, PANIC_AT_US);
+
+    std::string text = lb.text();
+    lb.close();
+    std::vector<Shown> shown = identify(STREAM_FRAMES);
+
+    int before = 0, after = 0, litAfter = 0;
+    for (const Shown &s : shown) {
+        if (s.us < press) {
+            before += s.frame >= 0;
+        } else {
+            after++;
+            litAfter += s.frame != -1;
+        }
+    }
+    printf("panic: pressed %.2f s after the first frame\n", PANIC_AT_US / 1e6);
+    printf("  %d frames shown before, %d after (%d lit), press-to-dark %u us\n", before, after, litAfter,
+           (unsigned)panicLatencyUs());
+    expect(before > 100, "stream running at the press");
+    expect(press != 0 && after > 0 && litAfter == 0, "only black after the press");
+    expect(panicDark() && panicLatencyUs() <= FRAME_PERIOD_US + FastLED.hostShowWireUs() + 1000,
+           "dark within a frame");
+    expect(text.find("PANIC STOP ACTIVATED") != std::string::npos, "panic reported");
+    return failures == 0 ? 0 : 1;
+}
+
+/* ---------------- MAIN ---------------- */
+
+// Fresh process per scenario: the sketch boots once
+static bool runChild(int (*scenario)()) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int rc = scenario();
+        fflush(stdout);
+        _exit(rc);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) {
+        perror("fork");
+        return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main() {
+    hostClockSetSimulated(false);
+    bool ok = runChild(checkStream);
+    ok = runChild(checkPanic) && ok;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/*
+    ================================================================
+                 FRAME STREAM SENDER (host → device)
+    ================================================================
+
+    Plays externally rendered frames on a device flashed with
+    FRAME_STREAM=1 (esp32dev_stream env), over its serial port. Frames
+    are sent in real time by presentation stamp (stream_sender.h), then
+    a STREAM_END, so the device goes dark and halts after the last one.
+    Whatever the device prints (console text, or binary telemetry for
+    telemetry_decode) is copied to stdout.
+
+    Frames come from a session file (session_file.h: its records are
+    stream frames already) or a built-in test pattern: the first half of
+    the strip at LEFT_FREQ_HZ, the second at RIGHT_FREQ_HZ, sinusoidal,
+    faded in over the first two seconds. Session-file frames already
+    carry render_session's master level, and the device applies its own
+    again.
+
+    The device's NUM_LEDS must match this build's.
+
+    Usage: stream_send <device> [-f session.bin] [-s seconds] [-a ahead-ms] [-b baud]
+      -f  session file to play (default: test pattern)
+      -s  stop after this much presentation time (default 10 s pattern,
+          whole file)
+      -a  send frames this far ahead of their deadline (default: the
+          pre-roll, STREAM_PREROLL_US)
+      -b  baud rate (default STREAM_BAUD)
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "session_file.h"
+#include "stream_sender.h"
+
+constexpr double PATTERN_FADE_IN_SECONDS = 2.0;
+
+static void patternFrame(uint64_t frame, uint8_t *rgb) {
+    double t = (double)(frame * FRAME_PERIOD_US) * 1e-6;
+    double fade = t < PATTERN_FADE_IN_SECONDS ? t / PATTERN_FADE_IN_SECONDS : 1.0;
+    for (int i = 0; i < NUM_LEDS; ++i) {
+        double hz = (i < NUM_LEDS / 2) ? LEFT_FREQ_HZ : RIGHT_FREQ_HZ;
+        double level = fade * (0.5 - 0.5 * cos(2.0 * M_PI * hz * t));
+        uint8_t v = (uint8_t)lround(level * 255.0);
+        rgb[3 * i] = rgb[3 * i + 1] = rgb[3 * i + 2] = v;
+    }
+}
+
+// Device output → stdout, until the process exits
+static void echoDevice(int fd) {
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) return;
+        fwrite(buf, 1, (size_t)n, stdout);
+        fflush(stdout);
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: stream_send <device> [-f session.bin] [-s seconds] [-a ahead-ms] [-b baud]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argv[1][0] == '-') usage();
+    const char *device = argv[1];
+    const char *sessionPath = nullptr;
+    double seconds = -1.0;
+    StreamPacer pacer;
+    uint32_t baud = STREAM_BAUD;
+    for (int i = 2; i < argc; ++i) {
+        if (i + 1 >= argc) usage();
+        if      (strcmp(argv[i], "-f") == 0) sessionPath = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0) pacer.aheadUs = (uint32_t)(atof(argv[++i]) * 1000.0);
+        else if (strcmp(argv[i], "-b") == 0) baud = (uint32_t)atol(argv[++i]);
+        else usage();
+    }
+    if (pacer.aheadUs >= STREAM_PREROLL_US + (STREAM_RING_FRAMES - 1) * FRAME_PERIOD_US) {
+        fprintf(stderr, "-a: at most %u ms with %d frame buffers\n",
+                (unsigned)((STREAM_PREROLL_US + (STREAM_RING_FRAMES - 1) * FRAME_PERIOD_US) / 1000 - 1),
+                STREAM_RING_FRAMES);
+        return 2;
+    }
+
+    SessionFile session;
+    if (sessionPath != nullptr) {
+        if (!session.open(sessionPath)) return 1;
+        if (session.header->numLeds != NUM_LEDS) {
+            fprintf(stderr, "%s: %u LEDs, this build sends %d\n", sessionPath,
+                    (unsigned)session.header->numLeds, NUM_LEDS);
+            return 1;
+        }
+    }
+    uint64_t frames = (sessionPath != nullptr) ? session.frameCount() : 0;
+    if (seconds < 0.0 && sessionPath == nullptr) seconds = 10.0;
+    if (seconds >= 0.0) {
+        uint64_t limit = (uint64_t)(seconds * 1e6 / FRAME_PERIOD_US);
+        if (sessionPath == nullptr || limit < frames) frames = limit;
+    }
+    if (frames == 0) {
+        fprintf(stderr, "nothing to send\n");
+        return 1;
+    }
+
+    int fd = openStreamPort(device, baud);
+    if (fd < 0) return 1;
+    std::thread(echoDevice, fd).detach();
+
+    std::vector<uint8_t> packet;
+    uint8_t rgb[NUM_LEDS * 3];
+    uint32_t lastUs = 0;
+    for (uint64_t f = 0; f < frames; ++f) {
+        const uint8_t *pixels = rgb;
+        if (sessionPath != nullptr) {
+            lastUs = session.presentUs(f);
+            pixels = session.rgb(f);
+        } else {
+            lastUs = (uint32_t)(f * FRAME_PERIOD_US);
+            patternFrame(f, rgb);
+        }
+        packet.clear();
+        streamEncodeFrame(packet, lastUs, pixels);
+        pacer.waitToSend(lastUs);
+        if (!writeAll(fd, packet.data(), packet.size())) {
+            perror(device);
+            return 1;
+        }
+    }
+
+    // Dark one frame after the last, then give the device time to report
+    packet.clear();
+    streamEncodeEnd(packet, lastUs + FRAME_PERIOD_US);
+    pacer.waitToSend(lastUs + FRAME_PERIOD_US);
+    if (!writeAll(fd, packet.data(), packet.size())) {
+        perror(device);
+        return 1;
+    }
+    usleep(STREAM_PREROLL_US + 500000);
+    fprintf(stderr, "sent %llu frames (%.1f s)\n", (unsigned long long)frames,
+            (double)(frames * FRAME_PERIOD_US) * 1e-6);
+    return 0;
+}
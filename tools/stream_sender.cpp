@@ -0,0 +1,129 @@
+#include "stream_sender.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ---------------- PACKETS ---------------- */
+
+static_assert(STREAM_FRAME_PAYLOAD <= STREAM_MAX_PAYLOAD, "stream frames limited to 21843 LEDs");
+
+void streamEncode(std::vector<uint8_t> &out, StreamType type, const void *payload, uint16_t len) {
+    const uint8_t header[STREAM_HEADER_BYTES] = {
+        STREAM_SYNC0, STREAM_SYNC1, type, 0, (uint8_t)(len & 0xff), (uint8_t)(len >> 8),
+    };
+    uint16_t crc = crc16Update(CRC16_INIT, header + 2, STREAM_HEADER_BYTES - 2);
+    crc = crc16Update(crc, (const uint8_t *)payload, len);
+
+    out.insert(out.end(), header, header + sizeof(header));
+    out.insert(out.end(), (const uint8_t *)payload, (const uint8_t *)payload + len);
+    out.push_back((uint8_t)(crc & 0xff));
+    out.push_back((uint8_t)(crc >> 8));
+}
+
+void streamEncodeFrame(std::vector<uint8_t> &out, uint32_t presentUs, const uint8_t *rgb) {
+    uint8_t payload[STREAM_FRAME_PAYLOAD];
+    StreamFrameHeader h = {presentUs};
+    memcpy(payload, &h, sizeof(h));
+    memcpy(payload + sizeof(h), rgb, NUM_LEDS * 3);
+    streamEncode(out, STREAM_FRAME, payload, (uint16_t)STREAM_FRAME_PAYLOAD);
+}
+
+void streamEncodeEnd(std::vector<uint8_t> &out, uint32_t presentUs) {
+    StreamFrameHeader h = {presentUs};
+    streamEncode(out, STREAM_END, &h, sizeof(h));
+}
+
+void streamEncodeKey(std::vector<uint8_t> &out, char key) {
+    streamEncode(out, STREAM_KEY, &key, 1);
+}
+
+/* ---------------- PORT ---------------- */
+
+static speed_t baudConstant(uint32_t baud) {
+    switch (baud) {
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        default:      return B0;
+    }
+}
+
+int openStreamPort(const char *path, uint32_t baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    if (!isatty(fd)) return fd;
+
+    speed_t speed = baudConstant(baud);
+    if (speed == B0) {
+        fprintf(stderr, "%s: unsupported baud rate %u\n", path, (unsigned)baud);
+        close(fd);
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool writeAll(int fd, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* ---------------- PACING ---------------- */
+
+uint64_t monotonicMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+void StreamPacer::waitToSend(uint32_t presentUs) {
+    if (!started) {
+        started = true;
+        startUs = monotonicMicros();
+        firstPresentUs = presentUs;
+        return;
+    }
+    // Shown at startUs + pre-roll + (presentUs - first); send aheadUs before
+    int64_t sendUs = (int64_t)startUs + STREAM_PREROLL_US + (int64_t)(uint32_t)(presentUs - firstPresentUs) -
+                     (int64_t)aheadUs;
+    int64_t waitUs = sendUs - (int64_t)monotonicMicros();
+    if (waitUs <= 0) return;
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(waitUs / 1000000);
+    ts.tv_nsec = (long)(waitUs % 1000000) * 1000L;
+    nanosleep(&ts, nullptr);
+}
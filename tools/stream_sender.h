@@ -0,0 +1,59 @@
+/*
+    ================================================================
+                    FRAME STREAM SENDER (host side)
+    ================================================================
+
+    Encodes stream_format.h packets and writes them to a serial port,
+    paced by presentation time. Shared by stream_send (to a device) and
+    stream_check (pty loopback against the host build of the sketch).
+
+    Pacing: the device shows the first frame STREAM_PREROLL_US after it
+    arrives, and every later frame at its presentUs relative to the
+    first. StreamPacer sends each frame `aheadUs` before that, so about
+    aheadUs / FRAME_PERIOD_US frames wait on the device to absorb host
+    and wire jitter. That must stay below STREAM_RING_FRAMES frame
+    periods; the default, the pre-roll, sends frames in real time.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "stream_format.h"
+
+// Append one framed packet to `out`
+void streamEncode(std::vector<uint8_t> &out, StreamType type, const void *payload, uint16_t len);
+
+// STREAM_FRAME with NUM_LEDS * 3 bytes of `rgb`
+void streamEncodeFrame(std::vector<uint8_t> &out, uint32_t presentUs, const uint8_t *rgb);
+void streamEncodeEnd(std::vector<uint8_t> &out, uint32_t presentUs);
+void streamEncodeKey(std::vector<uint8_t> &out, char key);
+
+/*
+    Open a serial device for writing and reading, raw 8N1 at `baud`
+    (ignored by ptys). Anything else that exists (a FIFO, a file) is
+    used as it is. -1 (and prints why) on failure.
+*/
+int openStreamPort(const char *path, uint32_t baud);
+
+// false on a write error
+bool writeAll(int fd, const uint8_t *data, size_t len);
+
+// CLOCK_MONOTONIC, μs
+uint64_t monotonicMicros();
+
+struct StreamPacer {
+    uint32_t aheadUs = STREAM_PREROLL_US;
+    uint64_t startUs = 0;           // wall time the first frame was sent
+    uint32_t firstPresentUs = 0;
+    bool     started = false;
+
+    /*
+        Sleep until the frame stamped `presentUs` is due to be sent. The
+        first call starts the clock and returns at once.
+    */
+    void waitToSend(uint32_t presentUs);
+};
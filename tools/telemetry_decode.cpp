@@ -0,0 +1,129 @@
+/*
+    ================================================================
+                   TELEMETRY DECODER COMMAND LINE (host)
+    ================================================================
+
+    Decodes a binary telemetry stream (firmware built with
+    BINARY_TELEMETRY=1) from a file, a serial device, or stdin.
+
+      - console lines (TELEM_TEXT) are printed as text
+      - session, stats and event records are printed as one line each
+      - with -f, every frame record goes to a CSV file
+      - a decoder summary goes to stderr at the end
+
+    Usage: telemetry_decode [input|-] [-f frames.csv]
+
+    For a serial port, set it raw first (stty -F /dev/ttyUSB0 115200 raw).
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry_decoder.h"
+
+static FILE    *csv = nullptr;
+static uint64_t frameCount = 0;
+static uint32_t maxFrameUs = 0;
+
+static void printPacket(const TelemetryPacket &pkt) {
+    switch (pkt.type) {
+        case TELEM_TEXT:
+            printf("%.*s\n", (int)pkt.len, (const char *)pkt.payload);
+            break;
+
+        case TELEM_FRAME: {
+            TelemetryFrame f;
+            if (!pkt.as(f)) break;
+            frameCount++;
+            if (f.frameUs > maxFrameUs) maxFrameUs = f.frameUs;
+            if (csv) {
+                fprintf(csv, "%u,%u,%u,%u,%.5f,%.5f,%.5f,%.5f,%u,%.5f,%u\n",
+                        (unsigned)f.index, (unsigned)f.sessionUs, (unsigned)f.startLatencyUs,
+                        (unsigned)f.frameUs, f.finalL / 32768.0, f.finalR / 32768.0,
+                        f.rampMul / 32768.0, f.breathe / 32768.0, (unsigned)f.mandalaMode,
+                        f.master / 32768.0, (unsigned)f.dropped);
+            }
+            break;
+        }
+
+        case TELEM_SESSION: {
+            TelemetrySession s;
+            if (!pkt.as(s)) break;
+            printf("[session] %u LEDs, %u us frames, L %.2f Hz, R %.2f Hz, ramp %.0f s, max %.0f s, %s, %s\n",
+                   (unsigned)s.numLeds, (unsigned)s.framePeriodUs, s.leftHz, s.rightHz,
+                   s.rampInSeconds, s.maxSessionSeconds, s.fixedPoint ? "Q15" : "float",
+                   s.dualCore ? "dual-core" : "single-core");
+            break;
+        }
+
+        case TELEM_STATS: {
+            TelemetryStats s;
+            if (!pkt.as(s)) break;
+            printf("[stats] frames %u, late %u, dropped %u, max start %u us, max frame %u us, "
+                   "offset %u us, telemetry dropped %u\n",
+                   (unsigned)s.frames, (unsigned)s.late, (unsigned)s.dropped,
+                   (unsigned)s.maxStartLatencyUs, (unsigned)s.maxFrameUs,
+                   (unsigned)s.presentationOffsetUs, (unsigned)s.telemetryDropped);
+            break;
+        }
+
+        case TELEM_EVENT: {
+            TelemetryEventRecord e;
+            if (!pkt.as(e)) break;
+            if (e.event == TELEM_EVENT_PANIC) {
+                printf("[event] panic stop, press-to-dark %u us\n", (unsigned)e.value);
+            } else if (e.event == TELEM_EVENT_SESSION_END) {
+                printf("[event] session end at %.1f s\n", e.value / 1000.0);
+            } else if (e.event == TELEM_EVENT_UNDERRUN) {
+                printf("[event] frame stream underrun at %.2f s\n", e.value / 1000.0);
+            } else {
+                printf("[event] %u (%u)\n", (unsigned)e.event, (unsigned)e.value);
+            }
+            break;
+        }
+
+        default:
+            printf("[unknown packet type %u, %u bytes]\n", (unsigned)pkt.type, (unsigned)pkt.len);
+            break;
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *inPath = "-";
+    const char *csvPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) csvPath = argv[++i];
+        else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) inPath = argv[i];
+        else {
+            fprintf(stderr, "usage: telemetry_decode [input|-] [-f frames.csv]\n");
+            return 2;
+        }
+    }
+
+    FILE *in = strcmp(inPath, "-") == 0 ? stdin : fopen(inPath, "rb");
+    if (in == nullptr) {
+        perror(inPath);
+        return 1;
+    }
+    if (csvPath) {
+        csv = fopen(csvPath, "w");
+        if (csv == nullptr) {
+            perror(csvPath);
+            return 1;
+        }
+        fprintf(csv, "index,session_us,start_latency_us,frame_us,final_l,final_r,ramp,breathe,mode,master,dropped\n");
+    }
+
+    TelemetryDecoder decoder(printPacket);
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) decoder.feed(chunk, n);
+
+    const TelemetryDecoderStats &st = decoder.stats();
+    fprintf(stderr, "%llu packets (%llu frames, max frame %u us), %llu lost, %llu CRC errors, %llu bytes skipped\n",
+            (unsigned long long)st.packets, (unsigned long long)frameCount, (unsigned)maxFrameUs,
+            (unsigned long long)st.lostPackets, (unsigned long long)st.crcErrors,
+            (unsigned long long)st.skippedBytes);
+    if (csv) fclose(csv);
+    return 0;
+}
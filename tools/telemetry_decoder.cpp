@@ -0,0 +1,47 @@
+#include "telemetry_decoder.h"
+
+void TelemetryDecoder::feed(const uint8_t *data, size_t len) {
+    buf.insert(buf.end(), data, data + len);
+
+    for (;;) {
+        // Find the next sync word
+        size_t start = pos;
+        while (pos + 1 < buf.size() && !(buf[pos] == TELEMETRY_SYNC0 && buf[pos + 1] == TELEMETRY_SYNC1)) pos++;
+        counters.skippedBytes += pos - start;
+
+        if (buf.size() - pos < (size_t)TELEMETRY_HEADER_BYTES) break;
+        const uint8_t *p = buf.data() + pos;
+        uint8_t plen = p[3];
+        size_t total = TELEMETRY_HEADER_BYTES + plen + TELEMETRY_CRC_BYTES;
+        if (buf.size() - pos < total) break;
+
+        uint16_t crc = crc16Update(CRC16_INIT, p + 2, TELEMETRY_HEADER_BYTES - 2 + plen);
+        uint16_t wire = (uint16_t)(p[total - 2] | (p[total - 1] << 8));
+        if (crc != wire) {
+            // Not a packet (or a damaged one): resync one byte further on
+            counters.crcErrors++;
+            counters.skippedBytes++;
+            pos++;
+            continue;
+        }
+
+        TelemetryPacket pkt;
+        pkt.type    = (TelemetryType)p[2];
+        pkt.len     = plen;
+        pkt.seq     = (uint16_t)(p[4] | (p[5] << 8));
+        pkt.payload = p + TELEMETRY_HEADER_BYTES;
+
+        if (haveSeq) counters.lostPackets += (uint16_t)(pkt.seq - lastSeq - 1);
+        haveSeq = true;
+        lastSeq = pkt.seq;
+        counters.packets++;
+        onPacket(pkt);
+        pos += total;
+    }
+
+    // Drop consumed bytes once they dominate the buffer
+    if (pos > 4096 && pos * 2 > buf.size()) {
+        buf.erase(buf.begin(), buf.begin() + (ptrdiff_t)pos);
+        pos = 0;
+    }
+}
@@ -0,0 +1,64 @@
+/*
+    ================================================================
+                  TELEMETRY DECODER LIBRARY (host)
+    ================================================================
+
+    Streaming parser for the packet format in src/telemetry_format.h.
+    Feed it bytes in chunks of any size, e.g. straight from a serial port
+    read(); complete, CRC-checked packets come out through the callback.
+
+    Garbage between packets (boot ROM output, a partial packet from before
+    the port was opened) is skipped by scanning for the next sync word
+    whose CRC checks out. Sequence gaps are counted as lost packets.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <vector>
+
+#include "telemetry_format.h"
+
+struct TelemetryPacket {
+    TelemetryType  type;
+    uint16_t       seq;
+    uint8_t        len;
+    const uint8_t *payload;   // valid only during the callback
+
+    // Typed view of a fixed-size payload; false if the size doesn't match
+    template <typename T> bool as(T &out) const {
+        if (len != sizeof(T)) return false;
+        memcpy(&out, payload, sizeof(T));
+        return true;
+    }
+};
+
+struct TelemetryDecoderStats {
+    uint64_t packets = 0;
+    uint64_t crcErrors = 0;
+    uint64_t lostPackets = 0;    // from sequence gaps
+    uint64_t skippedBytes = 0;   // bytes outside any valid packet
+};
+
+class TelemetryDecoder {
+public:
+    using Callback = std::function<void(const TelemetryPacket &)>;
+
+    explicit TelemetryDecoder(Callback onPacket) : onPacket(std::move(onPacket)) {}
+
+    void feed(const uint8_t *data, size_t len);
+
+    const TelemetryDecoderStats &stats() const { return counters; }
+
+private:
+    Callback              onPacket;
+    std::vector<uint8_t>  buf;
+    size_t                pos = 0;   // parse position in buf
+    bool                  haveSeq = false;
+    uint16_t              lastSeq = 0;
+    TelemetryDecoderStats counters;
+};